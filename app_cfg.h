@@ -37,4 +37,21 @@
 #define APP_CFG_SCL PB13
 #define APP_CFG_SDA PB15
 
+/**
+ * Periodic report of diagnostic counters on the serial port (0 = disabled, 1 = enabled).
+ */
+#define APP_CFG_DIAG 0
+
+/**
+ * Count drawing costs of the TFT and report them on the serial port for each state transition (0 = disabled,
+ * 1 = enabled).
+ */
+#define APP_CFG_TFT_METER 0
+
+/**
+ * Limit the progress updates on the TFT during loc database import and storage (0 = update for each loc,
+ * 1 = limited).
+ */
+#define APP_CFG_PROGRESS_PACING 1
+
 #endif
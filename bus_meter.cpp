@@ -0,0 +1,80 @@
+/***********************************************************************************************************************
+   @file   bus_meter.cpp
+   @brief  Count the XpNet messages and bytes transmitted by this device per category.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "bus_meter.h"
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+BusMeter::BusMeter()
+{
+    memset(m_Entries, 0, sizeof(m_Entries));
+    m_WindowStart = 0;
+}
+
+/***********************************************************************************************************************
+ */
+void BusMeter::Transmit(category Category, uint8_t Bytes)
+{
+    m_Entries[Category].Messages++;
+    m_Entries[Category].Bytes += Bytes;
+    m_Entries[Category].WindowBytes += Bytes;
+}
+
+/***********************************************************************************************************************
+ */
+void BusMeter::Update(uint32_t TimeStamp)
+{
+    uint8_t Index;
+    uint32_t Rate;
+    uint32_t Window = TimeStamp - m_WindowStart;
+
+    if (Window > 0)
+    {
+        for (Index = 0; Index < categories; Index++)
+        {
+            /* Bytes per second of this window, averaged with the previous windows. */
+            Rate                         = ((uint32_t)(m_Entries[Index].WindowBytes) * 1000) / Window;
+            m_Entries[Index].Rate        = (uint16_t)(((uint32_t)(m_Entries[Index].Rate) * 3 + Rate) / 4);
+            m_Entries[Index].WindowBytes = 0;
+        }
+
+        m_WindowStart = TimeStamp;
+    }
+}
+
+/***********************************************************************************************************************
+ */
+uint32_t BusMeter::MessagesGet(category Category) { return (m_Entries[Category].Messages); }
+
+/***********************************************************************************************************************
+ */
+uint32_t BusMeter::BytesGet(category Category) { return (m_Entries[Category].Bytes); }
+
+/***********************************************************************************************************************
+ */
+uint16_t BusMeter::RateGet(category Category) { return (m_Entries[Category].Rate); }
+
+/***********************************************************************************************************************
+ */
+uint16_t BusMeter::ShareGet(void)
+{
+    uint8_t Index;
+    uint32_t Rate = 0;
+
+    for (Index = 0; Index < categories; Index++)
+    {
+        Rate += m_Entries[Index].Rate;
+    }
+
+    /* Per mille of the bus capacity. */
+    return ((uint16_t)((Rate * 1000) / BUS_BYTES_PER_SEC));
+}
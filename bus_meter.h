@@ -0,0 +1,92 @@
+/**
+ **********************************************************************************************************************
+ * @file  bus_meter.h
+ * @brief Count the XpNet messages and bytes transmitted by this device per category.
+ ***********************************************************************************************************************
+ */
+#ifndef BUS_METER_H
+#define BUS_METER_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class BusMeter
+{
+public:
+    /**
+     * Message sizes in bytes including header and checksum.
+     */
+    static const uint8_t SIZE_LOC_INFO  = 5;
+    static const uint8_t SIZE_LOC_DRIVE = 6;
+    static const uint8_t SIZE_LOC_FUNC  = 6;
+    static const uint8_t SIZE_STATUS    = 3;
+    static const uint8_t SIZE_POWER     = 3;
+    static const uint8_t SIZE_TURNOUT   = 4;
+    static const uint8_t SIZE_CV_READ   = 4;
+    static const uint8_t SIZE_CV_WRITE  = 5;
+    static const uint8_t SIZE_CV_RESULT = 3;
+    static const uint8_t SIZE_POM_WRITE = 8;
+    static const uint8_t SIZE_LOC_DATA  = 7;
+
+    /**
+     * Message categories.
+     */
+    enum category
+    {
+        categoryDrive = 0,
+        categoryFunction,
+        categoryPoll,
+        categoryAccessory,
+        categoryCv,
+        categoryPower,
+        categoryLocDatabase,
+        categories,
+    };
+
+    /**
+     * Constructor.
+     */
+    BusMeter();
+
+    /**
+     * Count a transmitted message.
+     */
+    void Transmit(category Category, uint8_t Bytes);
+
+    /**
+     * Close the actual measuring window and update the rolling rates, call periodically.
+     */
+    void Update(uint32_t TimeStamp);
+
+    /**
+     * Statistics, totals since start up and rolling rates.
+     */
+    uint32_t MessagesGet(category Category);
+    uint32_t BytesGet(category Category);
+    uint16_t RateGet(category Category);
+    uint16_t ShareGet(void);
+
+private:
+    static const uint32_t BUS_BYTES_PER_SEC = 5682; /* 62.5 kbit/sec, 11 bits per byte. */
+
+    /**
+     * Counters of a category.
+     */
+    struct meterEntry
+    {
+        uint32_t Messages;
+        uint32_t Bytes;
+        uint16_t WindowBytes;
+        uint16_t Rate;
+    };
+
+    meterEntry m_Entries[categories];
+    uint32_t m_WindowStart;
+};
+
+#endif
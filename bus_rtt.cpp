@@ -0,0 +1,109 @@
+/***********************************************************************************************************************
+   @file   bus_rtt.cpp
+   @brief  Round trip time statistics of XpNet requests.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "bus_rtt.h"
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+BusRtt::BusRtt() { Clear(); }
+
+/***********************************************************************************************************************
+ */
+void BusRtt::Clear(void) { memset(m_Entries, 0, sizeof(m_Entries)); }
+
+/***********************************************************************************************************************
+ */
+bool BusRtt::Request(requestType Type, uint16_t Address, uint32_t TimeStamp)
+{
+    bool Result        = false;
+    rttEntry* EntryPtr = &m_Entries[Type];
+
+    if (EntryPtr->Pending == true)
+    {
+        if ((TimeStamp - EntryPtr->RequestTime) > RTT_TIMEOUT)
+        {
+            EntryPtr->Timeout++;
+            Result = true;
+        }
+        else
+        {
+            EntryPtr->Retry++;
+        }
+    }
+
+    EntryPtr->RequestTime = TimeStamp;
+    EntryPtr->Address     = Address;
+    EntryPtr->Pending     = true;
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool BusRtt::Response(requestType Type, uint16_t Address, uint32_t TimeStamp, uint32_t* RttPtr)
+{
+    uint32_t Time;
+    uint8_t Bucket     = 0;
+    bool Result        = false;
+    rttEntry* EntryPtr = &m_Entries[Type];
+
+    if ((EntryPtr->Pending == true) && (EntryPtr->Address == Address))
+    {
+        EntryPtr->Pending = false;
+        Time              = TimeStamp - EntryPtr->RequestTime;
+        *RttPtr           = Time;
+        Result            = true;
+
+        if (Time > RTT_TIMEOUT)
+        {
+            /* Late response, the request was very likely repeated meanwhile. */
+            EntryPtr->Timeout++;
+        }
+        else
+        {
+            while ((Time > 1) && (Bucket < (BUCKETS - 1)))
+            {
+                Time >>= 1;
+                Bucket++;
+            }
+
+            EntryPtr->Bucket[Bucket]++;
+            EntryPtr->Number++;
+            if ((TimeStamp - EntryPtr->RequestTime) > EntryPtr->Max)
+            {
+                EntryPtr->Max = TimeStamp - EntryPtr->RequestTime;
+            }
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+uint16_t BusRtt::BucketGet(requestType Type, uint8_t Bucket) { return (m_Entries[Type].Bucket[Bucket]); }
+
+/***********************************************************************************************************************
+ */
+uint16_t BusRtt::NumberGet(requestType Type) { return (m_Entries[Type].Number); }
+
+/***********************************************************************************************************************
+ */
+uint16_t BusRtt::MaxGet(requestType Type) { return (m_Entries[Type].Max); }
+
+/***********************************************************************************************************************
+ */
+uint16_t BusRtt::TimeoutGet(requestType Type) { return (m_Entries[Type].Timeout); }
+
+/***********************************************************************************************************************
+ */
+uint16_t BusRtt::RetryGet(requestType Type) { return (m_Entries[Type].Retry); }
@@ -0,0 +1,88 @@
+/**
+ **********************************************************************************************************************
+ * @file  bus_rtt.h
+ * @brief Round trip time statistics of XpNet requests.
+ ***********************************************************************************************************************
+ */
+#ifndef BUS_RTT_H
+#define BUS_RTT_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class BusRtt
+{
+public:
+    static const uint8_t BUCKETS       = 10; /* Bucket n holds times below 2^(n+1) msec, last one the rest. */
+    static const uint16_t ADDRESS_NONE = 0;  /* Address of requests without an address. */
+
+    /**
+     * Request types.
+     */
+    enum requestType
+    {
+        requestLocInfo = 0,
+        requestPower,
+        requestCvRead,
+        requestCvResult,
+        requestTypes,
+    };
+
+    /**
+     * Constructor.
+     */
+    BusRtt();
+
+    /**
+     * Clear all statistics.
+     */
+    void Clear(void);
+
+    /**
+     * A request for an address (for example a loc) is transmitted. If the previous request of the same type is still
+     * unanswered it is counted as retry or, when older than the timeout, as timeout. Returns true on a timeout.
+     */
+    bool Request(requestType Type, uint16_t Address, uint32_t TimeStamp);
+
+    /**
+     * A response is received, only matched when a request of the type for the same address is pending. Broadcasts
+     * for other addresses are not matched. Returns true and the round trip time when matched.
+     */
+    bool Response(requestType Type, uint16_t Address, uint32_t TimeStamp, uint32_t* RttPtr);
+
+    /**
+     * Statistics.
+     */
+    uint16_t BucketGet(requestType Type, uint8_t Bucket);
+    uint16_t NumberGet(requestType Type);
+    uint16_t MaxGet(requestType Type);
+    uint16_t TimeoutGet(requestType Type);
+    uint16_t RetryGet(requestType Type);
+
+private:
+    static const uint32_t RTT_TIMEOUT = 1000;
+
+    /**
+     * Statistics of a request type.
+     */
+    struct rttEntry
+    {
+        uint16_t Bucket[BUCKETS];
+        uint16_t Number;
+        uint16_t Max;
+        uint16_t Timeout;
+        uint16_t Retry;
+        uint32_t RequestTime;
+        uint16_t Address;
+        bool Pending;
+    };
+
+    rttEntry m_Entries[requestTypes];
+};
+
+#endif
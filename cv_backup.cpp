@@ -0,0 +1,130 @@
+/***********************************************************************************************************************
+   @file   cv_backup.cpp
+   @brief  Backup of decoder CVs in EEPROM, one page per loc.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "cv_backup.h"
+#include <stddef.h>
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+CvBackup::CvBackup() { m_EepPtr = NULL; }
+
+/***********************************************************************************************************************
+ */
+void CvBackup::Init(EepI2c& Eep) { m_EepPtr = &Eep; }
+
+/***********************************************************************************************************************
+ */
+bool CvBackup::Store(uint16_t LocAddress, CvBatch& Batch)
+{
+    bool Result = false;
+    uint8_t Index;
+    uint8_t IndexStore;
+    uint16_t CvNumber;
+    uint8_t CvValue;
+    backupRecord Record;
+
+    if (m_EepPtr != NULL)
+    {
+        /* Backup of the same loc, else a free one, else the one the loc address maps to. */
+        IndexStore = BACKUPS_MAX;
+        for (Index = 0; Index < BACKUPS_MAX; Index++)
+        {
+            if (Read(Index, &Record) == false)
+            {
+                if (IndexStore == BACKUPS_MAX)
+                {
+                    IndexStore = Index;
+                }
+            }
+            else if (Record.LocAddress == LocAddress)
+            {
+                IndexStore = Index;
+                break;
+            }
+        }
+
+        if (IndexStore == BACKUPS_MAX)
+        {
+            IndexStore = LocAddress % BACKUPS_MAX;
+        }
+
+        memset(&Record, 0, sizeof(backupRecord));
+        Record.Version    = EepCfg::CvBackupVersion;
+        Record.LocAddress = LocAddress;
+
+        for (Index = 0; (Index < Batch.NumberGet()) && (Record.Number < CV_MAX); Index++)
+        {
+            if ((Batch.Get(Index, &CvNumber, &CvValue) == true) && (CvNumber >= 1) && (CvNumber <= 256))
+            {
+                Record.Cv[Record.Number][0] = CvNumber - 1;
+                Record.Cv[Record.Number][1] = CvValue;
+                Record.Number++;
+            }
+        }
+
+        Record.Crc = EepI2c::Crc16((uint8_t*)(&Record), offsetof(backupRecord, Crc));
+
+        Result = m_EepPtr->WriteAsync(
+            EepCfg::CvBackupAddress + (IndexStore * EepCfg::EepromPageSize), (uint8_t*)(&Record), sizeof(backupRecord));
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool CvBackup::Load(uint16_t LocAddress, CvBatch& Batch)
+{
+    bool Result = false;
+    uint8_t Index;
+    uint8_t CvIndex;
+    backupRecord Record;
+
+    Batch.Clear();
+
+    for (Index = 0; Index < BACKUPS_MAX; Index++)
+    {
+        if ((Read(Index, &Record) == true) && (Record.LocAddress == LocAddress))
+        {
+            for (CvIndex = 0; CvIndex < Record.Number; CvIndex++)
+            {
+                Batch.Add(Record.Cv[CvIndex][0] + 1, Record.Cv[CvIndex][1]);
+            }
+
+            Result = true;
+            break;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool CvBackup::Read(uint8_t Index, backupRecord* RecordPtr)
+{
+    bool Result = false;
+
+    if ((m_EepPtr != NULL)
+        && (m_EepPtr->Read(EepCfg::CvBackupAddress + (Index * EepCfg::EepromPageSize), (uint8_t*)(RecordPtr),
+                sizeof(backupRecord))
+            == true))
+    {
+        if ((RecordPtr->Version == EepCfg::CvBackupVersion) && (RecordPtr->Number <= CV_MAX)
+            && (RecordPtr->Crc == EepI2c::Crc16((uint8_t*)(RecordPtr), offsetof(backupRecord, Crc))))
+        {
+            Result = true;
+        }
+    }
+
+    return (Result);
+}
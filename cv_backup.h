@@ -0,0 +1,68 @@
+/**
+ **********************************************************************************************************************
+ * @file  cv_backup.h
+ * @brief Backup of decoder CVs in EEPROM, one page per loc.
+ ***********************************************************************************************************************
+ */
+#ifndef CV_BACKUP_H
+#define CV_BACKUP_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include "cv_batch.h"
+#include "eep_cfg.h"
+#include "eep_i2c.h"
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class CvBackup
+{
+public:
+    static const uint8_t BACKUPS_MAX = 8;
+    static const uint8_t CV_MAX      = 29;
+
+    /**
+     * Constructor.
+     */
+    CvBackup();
+
+    /**
+     * Set the EEPROM used for the backups.
+     */
+    void Init(EepI2c& Eep);
+
+    /**
+     * Store the successfully read CVs of a batch as backup of a loc. A backup of the same loc is replaced.
+     */
+    bool Store(uint16_t LocAddress, CvBatch& Batch);
+
+    /**
+     * Fill a batch with the CVs and values of the backup of a loc, returns false when there is no backup.
+     */
+    bool Load(uint16_t LocAddress, CvBatch& Batch);
+
+private:
+    /**
+     * Backup as stored in EEPROM, exactly one page. CV numbers up to 256 are stored as CV number - 1.
+     */
+    struct backupRecord
+    {
+        uint8_t Version;
+        uint8_t Number;
+        uint16_t LocAddress;
+        uint8_t Cv[CV_MAX][2];
+        uint16_t Crc;
+    };
+
+    /**
+     * Read a backup, returns false when not valid.
+     */
+    bool Read(uint8_t Index, backupRecord* RecordPtr);
+
+    EepI2c* m_EepPtr;
+};
+
+#endif
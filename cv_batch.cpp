@@ -0,0 +1,247 @@
+/***********************************************************************************************************************
+   @file   cv_batch.cpp
+   @brief  Read or write a list of CVs in service mode with adaptive status polling.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "cv_batch.h"
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+CvBatch::CvBatch() { Clear(); }
+
+/***********************************************************************************************************************
+ */
+void CvBatch::Clear(void)
+{
+    m_Number       = 0;
+    m_Index        = 0;
+    m_Retry        = 0;
+    m_Active       = false;
+    m_Write        = false;
+    m_Requested    = false;
+    m_Busy         = false;
+    m_RequestTime  = 0;
+    m_PollTime     = 0;
+    m_PollInterval = POLL_TIME_MIN;
+}
+
+/***********************************************************************************************************************
+ */
+bool CvBatch::Add(uint16_t CvNumber, uint8_t CvValue)
+{
+    bool Result = false;
+
+    if ((m_Active == false) && (m_Number < CV_MAX))
+    {
+        m_Cv[m_Number].CvNumber = CvNumber;
+        m_Cv[m_Number].CvValue  = CvValue;
+        m_Cv[m_Number].Status   = cvPending;
+        m_Cv[m_Number].Latency  = 0;
+        m_Number++;
+        Result = true;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+void CvBatch::Start(bool Write)
+{
+    uint8_t Index;
+
+    for (Index = 0; Index < m_Number; Index++)
+    {
+        m_Cv[Index].Status  = cvPending;
+        m_Cv[Index].Latency = 0;
+    }
+
+    m_Index     = 0;
+    m_Retry     = 0;
+    m_Write     = Write;
+    m_Requested = false;
+    m_Busy      = false;
+    m_Active    = (m_Number > 0);
+}
+
+/***********************************************************************************************************************
+ */
+bool CvBatch::Active(void) { return (m_Active); }
+
+/***********************************************************************************************************************
+ */
+CvBatch::request CvBatch::Update(uint32_t TimeStamp, uint16_t* CvNumberPtr, uint8_t* CvValuePtr)
+{
+    request Result = requestNone;
+
+    if (m_Active == true)
+    {
+        if ((m_Requested == false) && (m_Busy == false))
+        {
+            /* Next CV. */
+            *CvNumberPtr   = m_Cv[m_Index].CvNumber;
+            *CvValuePtr    = m_Cv[m_Index].CvValue;
+            m_Requested    = true;
+            m_RequestTime  = TimeStamp;
+            m_PollTime     = TimeStamp;
+            m_PollInterval = POLL_TIME_MIN;
+            Result         = (m_Write == true) ? requestWrite : requestRead;
+        }
+        else if ((TimeStamp - m_RequestTime) > CV_TIMEOUT)
+        {
+            Finish(cvFailed, TimeStamp);
+        }
+        else if ((TimeStamp - m_PollTime) >= m_PollInterval)
+        {
+            m_PollTime = TimeStamp;
+            if (m_Busy == true)
+            {
+                /* Central was busy, transmit the same CV again. */
+                *CvNumberPtr = m_Cv[m_Index].CvNumber;
+                *CvValuePtr  = m_Cv[m_Index].CvValue;
+                m_Busy       = false;
+                m_Requested  = true;
+                Result       = (m_Write == true) ? requestWrite : requestRead;
+            }
+            else
+            {
+                Result = requestStatus;
+            }
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+void CvBatch::Response(const cvResponseData* ResponsePtr, uint32_t TimeStamp)
+{
+    if ((m_Active == true) && (m_Requested == true))
+    {
+        switch (ResponsePtr->cvInfo)
+        {
+        case centralBusy:
+            /* Transmit the request again, back off while the central stays busy. */
+            m_PollInterval = m_PollInterval * 2;
+            if (m_PollInterval > POLL_TIME_MAX)
+            {
+                m_PollInterval = POLL_TIME_MAX;
+            }
+            m_PollTime  = TimeStamp;
+            m_Busy      = true;
+            m_Requested = false;
+            break;
+        case centralReady:
+            if (m_Write == true)
+            {
+                Finish(cvOk, TimeStamp);
+            }
+            break;
+        case dataReady:
+            if (m_Write == false)
+            {
+                m_Cv[m_Index].CvValue = ResponsePtr->cvValue;
+            }
+            Finish(cvOk, TimeStamp);
+            break;
+        case transmitError:
+            /* Transmit the request again. */
+            if (m_Retry < RETRY_MAX)
+            {
+                m_Retry++;
+                m_Requested = false;
+            }
+            else
+            {
+                Finish(cvFailed, TimeStamp);
+            }
+            break;
+        case dataNotFound:
+        case centralShotCircuit: Finish(cvFailed, TimeStamp); break;
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ */
+uint8_t CvBatch::NumberGet(void) { return (m_Number); }
+
+/***********************************************************************************************************************
+ */
+uint8_t CvBatch::DoneGet(void) { return (m_Index); }
+
+/***********************************************************************************************************************
+ */
+uint8_t CvBatch::FailedGet(void)
+{
+    uint8_t Index;
+    uint8_t Failed = 0;
+
+    for (Index = 0; Index < m_Number; Index++)
+    {
+        if (m_Cv[Index].Status == cvFailed)
+        {
+            Failed++;
+        }
+    }
+
+    return (Failed);
+}
+
+/***********************************************************************************************************************
+ */
+bool CvBatch::Get(uint8_t Index, uint16_t* CvNumberPtr, uint8_t* CvValuePtr)
+{
+    bool Result = false;
+
+    if (Index < m_Number)
+    {
+        *CvNumberPtr = m_Cv[Index].CvNumber;
+        *CvValuePtr  = m_Cv[Index].CvValue;
+        Result       = (m_Cv[Index].Status == cvOk);
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+uint16_t CvBatch::LatencyGet(uint8_t Index)
+{
+    uint16_t Result = 0;
+
+    if (Index < m_Number)
+    {
+        Result = m_Cv[Index].Latency;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+void CvBatch::Finish(cvStatus Status, uint32_t TimeStamp)
+{
+    uint32_t Latency = TimeStamp - m_RequestTime;
+
+    m_Cv[m_Index].Status  = Status;
+    m_Cv[m_Index].Latency = (Latency > 0xFFFF) ? 0xFFFF : Latency;
+
+    m_Index++;
+    m_Retry     = 0;
+    m_Requested = false;
+    m_Busy      = false;
+
+    if (m_Index >= m_Number)
+    {
+        m_Active = false;
+    }
+}
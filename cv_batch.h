@@ -0,0 +1,126 @@
+/**
+ **********************************************************************************************************************
+ * @file  cv_batch.h
+ * @brief Read or write a list of CVs in service mode with adaptive status polling.
+ ***********************************************************************************************************************
+ */
+#ifndef CV_BATCH_H
+#define CV_BATCH_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+#include "xmc_event.h"
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class CvBatch
+{
+public:
+    static const uint8_t CV_MAX = 32;
+
+    /**
+     * Request to be transmitted.
+     */
+    enum request
+    {
+        requestNone = 0,
+        requestRead,
+        requestWrite,
+        requestStatus,
+    };
+
+    /**
+     * Constructor.
+     */
+    CvBatch();
+
+    /**
+     * Remove all CVs.
+     */
+    void Clear(void);
+
+    /**
+     * Add a CV, the value is only used when writing.
+     */
+    bool Add(uint16_t CvNumber, uint8_t CvValue);
+
+    /**
+     * Start reading or writing all CVs.
+     */
+    void Start(bool Write);
+
+    /**
+     * Check if reading or writing is ongoing.
+     */
+    bool Active(void);
+
+    /**
+     * Get the request to be transmitted now, call frequently. The status is requested quickly after a read or write.
+     * When the central reports busy the read or write is transmitted again, with doubling intervals while the central
+     * stays busy.
+     */
+    request Update(uint32_t TimeStamp, uint16_t* CvNumberPtr, uint8_t* CvValuePtr);
+
+    /**
+     * Handle a response of the central.
+     */
+    void Response(const cvResponseData* ResponsePtr, uint32_t TimeStamp);
+
+    /**
+     * Results.
+     */
+    uint8_t NumberGet(void);
+    uint8_t DoneGet(void);
+    uint8_t FailedGet(void);
+    bool Get(uint8_t Index, uint16_t* CvNumberPtr, uint8_t* CvValuePtr);
+    uint16_t LatencyGet(uint8_t Index);
+
+private:
+    static const uint32_t POLL_TIME_MIN = 50;
+    static const uint32_t POLL_TIME_MAX = 800;
+    static const uint32_t CV_TIMEOUT    = 10000;
+    static const uint8_t RETRY_MAX      = 3;
+
+    /**
+     * Status of a CV.
+     */
+    enum cvStatus
+    {
+        cvPending = 0,
+        cvOk,
+        cvFailed,
+    };
+
+    /**
+     * CV with result.
+     */
+    struct cvEntry
+    {
+        uint16_t CvNumber;
+        uint8_t CvValue;
+        uint8_t Status;
+        uint16_t Latency;
+    };
+
+    /**
+     * Store the result of the actual CV and continue with the next one.
+     */
+    void Finish(cvStatus Status, uint32_t TimeStamp);
+
+    cvEntry m_Cv[CV_MAX];
+    uint8_t m_Number;
+    uint8_t m_Index;
+    uint8_t m_Retry;
+    bool m_Active;
+    bool m_Write;
+    bool m_Requested;
+    bool m_Busy;
+    uint32_t m_RequestTime;
+    uint32_t m_PollTime;
+    uint32_t m_PollInterval;
+};
+
+#endif
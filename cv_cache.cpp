@@ -0,0 +1,120 @@
+/***********************************************************************************************************************
+   @file   cv_cache.cpp
+   @brief  Cache with the last read CV values of recently programmed decoders.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "cv_cache.h"
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+CvCache::CvCache()
+{
+    m_Hit  = 0;
+    m_Miss = 0;
+    Clear();
+}
+
+/***********************************************************************************************************************
+ */
+void CvCache::Clear(void)
+{
+    uint8_t Index;
+
+    for (Index = 0; Index < CACHE_SIZE; Index++)
+    {
+        m_Entries[Index].Valid = false;
+    }
+
+    m_IndexNext = 0;
+}
+
+/***********************************************************************************************************************
+ */
+void CvCache::Store(uint16_t Address, uint16_t CvNumber, uint8_t CvValue)
+{
+    uint8_t Index;
+    uint8_t IndexStore = m_IndexNext;
+
+    for (Index = 0; Index < CACHE_SIZE; Index++)
+    {
+        if ((m_Entries[Index].Valid == true) && (m_Entries[Index].Address == Address)
+            && (m_Entries[Index].CvNumber == CvNumber))
+        {
+            /* CV already present, refresh it. */
+            IndexStore = Index;
+            break;
+        }
+    }
+
+    if (IndexStore == m_IndexNext)
+    {
+        /* Entries are replaced in the order they were stored. */
+        m_IndexNext = (m_IndexNext + 1) % CACHE_SIZE;
+    }
+
+    m_Entries[IndexStore].Address  = Address;
+    m_Entries[IndexStore].CvNumber = CvNumber;
+    m_Entries[IndexStore].CvValue  = CvValue;
+    m_Entries[IndexStore].Valid    = true;
+}
+
+/***********************************************************************************************************************
+ */
+bool CvCache::Get(uint16_t Address, uint16_t CvNumber, uint8_t* CvValuePtr)
+{
+    uint8_t Index;
+    bool Result = false;
+
+    for (Index = 0; Index < CACHE_SIZE; Index++)
+    {
+        if ((m_Entries[Index].Valid == true) && (m_Entries[Index].Address == Address)
+            && (m_Entries[Index].CvNumber == CvNumber))
+        {
+            *CvValuePtr = m_Entries[Index].CvValue;
+            Result      = true;
+            break;
+        }
+    }
+
+    if (Result == true)
+    {
+        m_Hit++;
+    }
+    else
+    {
+        m_Miss++;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+void CvCache::Invalidate(uint16_t Address, uint16_t CvNumber)
+{
+    uint8_t Index;
+
+    for (Index = 0; Index < CACHE_SIZE; Index++)
+    {
+        if ((m_Entries[Index].Valid == true) && (m_Entries[Index].Address == Address)
+            && (m_Entries[Index].CvNumber == CvNumber))
+        {
+            m_Entries[Index].Valid = false;
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ */
+uint16_t CvCache::HitGet(void) { return (m_Hit); }
+
+/***********************************************************************************************************************
+ */
+uint16_t CvCache::MissGet(void) { return (m_Miss); }
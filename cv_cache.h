@@ -0,0 +1,72 @@
+/**
+ **********************************************************************************************************************
+ * @file  cv_cache.h
+ * @brief Cache with the last read CV values of recently programmed decoders.
+ ***********************************************************************************************************************
+ */
+#ifndef CV_CACHE_H
+#define CV_CACHE_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class CvCache
+{
+public:
+    /**
+     * Constructor.
+     */
+    CvCache();
+
+    /**
+     * Invalidate all entries.
+     */
+    void Clear(void);
+
+    /**
+     * Store (or refresh) the value of a CV of a loc. If not present the oldest stored entry is replaced.
+     */
+    void Store(uint16_t Address, uint16_t CvNumber, uint8_t CvValue);
+
+    /**
+     * Get the cached value of a CV of a loc. Returns false if not present.
+     */
+    bool Get(uint16_t Address, uint16_t CvNumber, uint8_t* CvValuePtr);
+
+    /**
+     * Remove a CV of a loc from the cache.
+     */
+    void Invalidate(uint16_t Address, uint16_t CvNumber);
+
+    /**
+     * Statistics.
+     */
+    uint16_t HitGet(void);
+    uint16_t MissGet(void);
+
+private:
+    static const uint8_t CACHE_SIZE = 32;
+
+    /**
+     * Cache entry.
+     */
+    struct cacheEntry
+    {
+        uint16_t Address;
+        uint16_t CvNumber;
+        uint8_t CvValue;
+        bool Valid;
+    };
+
+    cacheEntry m_Entries[CACHE_SIZE];
+    uint8_t m_IndexNext;
+    uint16_t m_Hit;
+    uint16_t m_Miss;
+};
+
+#endif
@@ -20,15 +20,24 @@ class EepCfg
 public:
     static const uint8_t EepromVersion   = 3;  /* Version of data in EEPROM. */
     static const uint32_t EepromPageSize = 64; /* 24LC256 page size. */
+    static const uint8_t SnapshotVersion = 2;  /* Version of warm resume snapshot. */
+    static const uint8_t SettingsVersion = 1;  /* Version of settings header. */
+    static const uint8_t RouteVersion    = 1;  /* Version of route records. */
+    static const uint8_t CvBackupVersion = 1;  /* Version of CV backup records. */
 
-    static const int EepromVersionAddress         = 0;  /* EEPROM address version info. */
-    static const int AcTypeControlAddress         = 2;  /* EEPROM address for "AC" type control */
-    static const int XpNetAddress                 = 4;  /* EEPROM address of Xpnet address */
-    static const int EmergencyStopEnabledAddress  = 6;  /* EEPROM address for emergency option. */
-    static const int locLibEepromAddressNumOfLocs = 8;  /* EEPROM address number of locs. */
-    static const int SelectedLocAddress           = 10; /* EEPROM address for storage last selected loc. */
-    static const int PulseSwitchInvertAddress     = 12; /* EEPROM address inverted behavior pulse switch. */
-    static const int AutoOffAddress               = 14; /* EEPROM address for turnout auto off command. */
-    static const int locLibEepromAddressLocData   = 64; /* EEPROM address number of locs. */
+    static const int EepromVersionAddress         = 0;     /* EEPROM address version info. */
+    static const int AcTypeControlAddress         = 2;     /* EEPROM address for "AC" type control */
+    static const int XpNetAddress                 = 4;     /* EEPROM address of Xpnet address */
+    static const int EmergencyStopEnabledAddress  = 6;     /* EEPROM address for emergency option. */
+    static const int locLibEepromAddressNumOfLocs = 8;     /* EEPROM address number of locs. */
+    static const int SelectedLocAddress           = 10;    /* EEPROM address for storage last selected loc. */
+    static const int PulseSwitchInvertAddress     = 12;    /* EEPROM address inverted behavior pulse switch. */
+    static const int AutoOffAddress               = 14;    /* EEPROM address for turnout auto off command. */
+    static const int SettingsHeaderAddress        = 16;    /* EEPROM address CRC of settings 0..15. */
+    static const int TurnoutPulseTimeAddress      = 20;    /* EEPROM address turnout pulse time in 10 msec units. */
+    static const int locLibEepromAddressLocData   = 64;    /* EEPROM address number of locs. */
+    static const int CvBackupAddress              = 31168; /* EEPROM address CV backups, one page per loc. */
+    static const int RouteAddress                 = 31680; /* EEPROM address routes, one page per route. */
+    static const int SnapshotAddress              = 32704; /* EEPROM address warm resume snapshot (last page). */
 };
 #endif
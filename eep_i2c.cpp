@@ -0,0 +1,336 @@
+/***********************************************************************************************************************
+   @file   eep_i2c.cpp
+   @brief  Direct access to the 24LC256 I2C EEPROM for application data blocks.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "eep_i2c.h"
+#include "eep_cfg.h"
+#include <Wire.h>
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+EepI2c::EepI2c()
+{
+    m_QueueCnt     = 0;
+    m_Busy         = false;
+    m_PagesWritten = 0;
+    m_QueueFull    = 0;
+    m_WaitTime     = 0;
+}
+
+/***********************************************************************************************************************
+ */
+void EepI2c::Init(void) { Wire.begin(); }
+
+/***********************************************************************************************************************
+ */
+bool EepI2c::Read(uint16_t Address, uint8_t* DataPtr, uint16_t Length)
+{
+    bool Result = true;
+    uint8_t Chunk;
+    uint8_t Index;
+    uint8_t* ReadPtr    = DataPtr;
+    uint16_t ReadAddres = Address;
+    uint16_t ReadLength = Length;
+    uint16_t Offset;
+    uint16_t QueueAddress;
+
+    /* The EEPROM does not respond during a write cycle. */
+    if (m_Busy == true)
+    {
+        WaitReady();
+    }
+
+    while ((ReadLength > 0) && (Result == true))
+    {
+        Chunk = (ReadLength > I2C_READ_SIZE) ? I2C_READ_SIZE : ReadLength;
+
+        Wire.beginTransmission(I2C_ADDRESS);
+        Wire.write((uint8_t)(ReadAddres >> 8));
+        Wire.write((uint8_t)(ReadAddres));
+
+        if (Wire.endTransmission() != 0)
+        {
+            Result = false;
+        }
+        else if (Wire.requestFrom(I2C_ADDRESS, Chunk) != Chunk)
+        {
+            Result = false;
+        }
+        else
+        {
+            for (Index = 0; Index < Chunk; Index++)
+            {
+                *ReadPtr++ = Wire.read();
+            }
+
+            ReadAddres += Chunk;
+            ReadLength -= Chunk;
+        }
+    }
+
+    /* Overlay data not written yet, oldest first so the latest queued data wins. */
+    for (Index = 0; Index < m_QueueCnt; Index++)
+    {
+        for (Offset = 0; Offset < m_Queue[Index].Length; Offset++)
+        {
+            QueueAddress = m_Queue[Index].Address + Offset;
+            if ((QueueAddress >= Address) && (QueueAddress < (Address + Length)))
+            {
+                DataPtr[QueueAddress - Address] = m_Queue[Index].Data[Offset];
+            }
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool EepI2c::Write(uint16_t Address, const uint8_t* DataPtr, uint16_t Length)
+{
+    bool Result;
+    uint8_t Chunk;
+
+    /* Keep order of writes. */
+    Result = Flush();
+
+    while ((Length > 0) && (Result == true))
+    {
+        Chunk  = ChunkGet(Address, Length);
+        Result = WritePageStart(Address, DataPtr, Chunk);
+        if (Result == true)
+        {
+            Result = WaitReady();
+        }
+
+        Address += Chunk;
+        DataPtr += Chunk;
+        Length -= Chunk;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool EepI2c::WriteAsync(uint16_t Address, const uint8_t* DataPtr, uint16_t Length)
+{
+    bool Result = true;
+    uint8_t Chunk;
+    uint8_t Index;
+
+    while ((Length > 0) && (Result == true))
+    {
+        Chunk = ChunkGet(Address, Length);
+
+        /* Replace a queued write of the same block. */
+        for (Index = 0; Index < m_QueueCnt; Index++)
+        {
+            if ((m_Queue[Index].Address == Address) && (m_Queue[Index].Length == Chunk))
+            {
+                break;
+            }
+        }
+
+        if (Index == m_QueueCnt)
+        {
+            if (m_QueueCnt == QUEUE_SIZE)
+            {
+                m_QueueFull++;
+                Result = QueueWriteOldest();
+            }
+
+            Index = m_QueueCnt;
+            m_QueueCnt++;
+        }
+
+        m_Queue[Index].Address = Address;
+        m_Queue[Index].Length  = Chunk;
+        memcpy(m_Queue[Index].Data, DataPtr, Chunk);
+
+        Address += Chunk;
+        DataPtr += Chunk;
+        Length -= Chunk;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+void EepI2c::Update(void)
+{
+    if (m_Busy == true)
+    {
+        Ready();
+    }
+
+    if ((m_Busy == false) && (m_QueueCnt > 0))
+    {
+        QueueWriteOldest();
+    }
+}
+
+/***********************************************************************************************************************
+ */
+bool EepI2c::Flush(void)
+{
+    bool Result = true;
+
+    while ((m_QueueCnt > 0) && (Result == true))
+    {
+        Result = QueueWriteOldest();
+    }
+
+    if (m_Busy == true)
+    {
+        Result = WaitReady();
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+uint32_t EepI2c::PagesWrittenGet(void) { return (m_PagesWritten); }
+
+/***********************************************************************************************************************
+ */
+uint32_t EepI2c::QueueFullGet(void) { return (m_QueueFull); }
+
+/***********************************************************************************************************************
+ */
+uint32_t EepI2c::WaitTimeGet(void) { return (m_WaitTime); }
+
+/***********************************************************************************************************************
+ */
+uint16_t EepI2c::Crc16(const uint8_t* DataPtr, uint16_t Length, uint16_t Crc)
+{
+    uint8_t Bit;
+
+    while (Length > 0)
+    {
+        Crc ^= (uint16_t)(*DataPtr++) << 8;
+        for (Bit = 0; Bit < 8; Bit++)
+        {
+            if ((Crc & 0x8000) != 0)
+            {
+                Crc = (Crc << 1) ^ 0x1021;
+            }
+            else
+            {
+                Crc <<= 1;
+            }
+        }
+        Length--;
+    }
+
+    return (Crc);
+}
+
+/***********************************************************************************************************************
+ */
+uint8_t EepI2c::ChunkGet(uint16_t Address, uint16_t Length)
+{
+    uint16_t Chunk;
+
+    /* Page writes may not cross a page boundary. */
+    Chunk = EepCfg::EepromPageSize - (Address % EepCfg::EepromPageSize);
+    if (Chunk > I2C_WRITE_SIZE)
+    {
+        Chunk = I2C_WRITE_SIZE;
+    }
+    if (Chunk > Length)
+    {
+        Chunk = Length;
+    }
+
+    return (static_cast<uint8_t>(Chunk));
+}
+
+/***********************************************************************************************************************
+ */
+bool EepI2c::WritePageStart(uint16_t Address, const uint8_t* DataPtr, uint8_t Length)
+{
+    bool Result = false;
+
+    if (m_Busy == true)
+    {
+        WaitReady();
+    }
+
+    Wire.beginTransmission(I2C_ADDRESS);
+    Wire.write((uint8_t)(Address >> 8));
+    Wire.write((uint8_t)(Address));
+    Wire.write(DataPtr, Length);
+
+    if (Wire.endTransmission() == 0)
+    {
+        m_Busy = true;
+        m_PagesWritten++;
+        Result = true;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool EepI2c::Ready(void)
+{
+    /* The EEPROM does not acknowledge its address while the internal write cycle is active. */
+    Wire.beginTransmission(I2C_ADDRESS);
+    if (Wire.endTransmission() == 0)
+    {
+        m_Busy = false;
+    }
+
+    return (m_Busy == false);
+}
+
+/***********************************************************************************************************************
+ */
+bool EepI2c::WaitReady(void)
+{
+    bool Result;
+    uint32_t Start   = micros();
+    uint32_t Timeout = millis();
+
+    do
+    {
+        Result = Ready();
+    } while ((Result == false) && ((millis() - Timeout) < WRITE_CYCLE_TIMEOUT));
+
+    m_WaitTime += micros() - Start;
+
+    /* Write cycle takes too long, continue anyway. */
+    m_Busy = false;
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool EepI2c::QueueWriteOldest(void)
+{
+    bool Result;
+    uint8_t Index;
+
+    Result = WritePageStart(m_Queue[0].Address, m_Queue[0].Data, m_Queue[0].Length);
+
+    for (Index = 1; Index < m_QueueCnt; Index++)
+    {
+        memcpy(&m_Queue[Index - 1], &m_Queue[Index], sizeof(queueEntry));
+    }
+    m_QueueCnt--;
+
+    return (Result);
+}
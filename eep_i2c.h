@@ -0,0 +1,119 @@
+/**
+ **********************************************************************************************************************
+ * @file  eep_i2c.h
+ * @brief Direct access to the 24LC256 I2C EEPROM for application data blocks.
+ ***********************************************************************************************************************
+ */
+#ifndef EEP_I2C_H
+#define EEP_I2C_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class EepI2c
+{
+public:
+    /**
+     * Constructor.
+     */
+    EepI2c();
+
+    /**
+     * Init the I2C bus.
+     */
+    void Init(void);
+
+    /**
+     * Read data in sequential bursts. Data still waiting in the write queue is returned instead of the EEPROM data.
+     */
+    bool Read(uint16_t Address, uint8_t* DataPtr, uint16_t Length);
+
+    /**
+     * Write data in page writes, waits until each page is written.
+     */
+    bool Write(uint16_t Address, const uint8_t* DataPtr, uint16_t Length);
+
+    /**
+     * Queue data to be written by Update(). A queued write of the same block is replaced. If the queue is full the
+     * oldest queued page is written first.
+     */
+    bool WriteAsync(uint16_t Address, const uint8_t* DataPtr, uint16_t Length);
+
+    /**
+     * Start the next queued page write when the previous write cycle is finished, does not wait.
+     */
+    void Update(void);
+
+    /**
+     * Write all queued pages and wait until finished. Call before other code accesses the EEPROM.
+     */
+    bool Flush(void);
+
+    /**
+     * Statistics.
+     */
+    uint32_t PagesWrittenGet(void);
+    uint32_t QueueFullGet(void);
+    uint32_t WaitTimeGet(void);
+
+    /**
+     * Calculate CRC16 (CCITT) of data, continue with the CRC of a previous block if required.
+     */
+    static uint16_t Crc16(const uint8_t* DataPtr, uint16_t Length, uint16_t Crc = 0xFFFF);
+
+private:
+    static const uint8_t I2C_ADDRESS         = 0x50;
+    static const uint8_t I2C_READ_SIZE       = 32; /* Wire buffer size. */
+    static const uint8_t I2C_WRITE_SIZE      = 30; /* Wire buffer size minus two address bytes. */
+    static const uint8_t WRITE_CYCLE_TIMEOUT = 10; /* Max write cycle time 5 msec. */
+    static const uint8_t QUEUE_SIZE          = 4;
+
+    /**
+     * Queued page write.
+     */
+    struct queueEntry
+    {
+        uint16_t Address;
+        uint8_t Length;
+        uint8_t Data[I2C_WRITE_SIZE];
+    };
+
+    /**
+     * Length of the part of a write which fits in one page write.
+     */
+    uint8_t ChunkGet(uint16_t Address, uint16_t Length);
+
+    /**
+     * Transmit data within one page, the internal write cycle is started afterwards.
+     */
+    bool WritePageStart(uint16_t Address, const uint8_t* DataPtr, uint8_t Length);
+
+    /**
+     * Check once if the internal write cycle is finished (acknowledge polling).
+     */
+    bool Ready(void);
+
+    /**
+     * Wait until the internal write cycle is finished.
+     */
+    bool WaitReady(void);
+
+    /**
+     * Write the oldest queued page.
+     */
+    bool QueueWriteOldest(void);
+
+    queueEntry m_Queue[QUEUE_SIZE];
+    uint8_t m_QueueCnt;
+    bool m_Busy;
+    uint32_t m_PagesWritten;
+    uint32_t m_QueueFull;
+    uint32_t m_WaitTime;
+};
+
+#endif
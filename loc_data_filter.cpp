@@ -0,0 +1,80 @@
+/***********************************************************************************************************************
+   @file   loc_data_filter.cpp
+   @brief  Detection of unchanged loc data responses before they are dispatched to the application.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "loc_data_filter.h"
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+LocDataFilter::LocDataFilter()
+{
+    m_Fingerprint = 0;
+    m_TimeStamp   = 0;
+    m_Valid       = false;
+    m_Force       = false;
+    m_Received    = 0;
+    m_Dropped     = 0;
+}
+
+/***********************************************************************************************************************
+ */
+bool LocDataFilter::Check(const locData* DataPtr, uint32_t TimeStamp)
+{
+    bool Result          = true;
+    uint64_t Fingerprint = FingerprintGet(DataPtr);
+
+    m_Received++;
+
+    if ((m_Force == false) && (m_Valid == true) && (Fingerprint == m_Fingerprint)
+        && ((TimeStamp - m_TimeStamp) < REFRESH_TIME))
+    {
+        m_Dropped++;
+        Result = false;
+    }
+    else
+    {
+        m_Fingerprint = Fingerprint;
+        m_TimeStamp   = TimeStamp;
+        m_Valid       = true;
+        m_Force       = false;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+void LocDataFilter::Force(void) { m_Force = true; }
+
+/***********************************************************************************************************************
+ */
+uint32_t LocDataFilter::ReceivedGet(void) { return (m_Received); }
+
+/***********************************************************************************************************************
+ */
+uint32_t LocDataFilter::DroppedGet(void) { return (m_Dropped); }
+
+/***********************************************************************************************************************
+ */
+uint64_t LocDataFilter::FingerprintGet(const locData* DataPtr)
+{
+    uint64_t Fingerprint;
+
+    /* Functions F0..F28 use the lower 29 bits. */
+    Fingerprint = (uint64_t)(DataPtr->Address) << 48;
+    Fingerprint |= (uint64_t)(DataPtr->Steps & 0x07) << 45;
+    Fingerprint |= (uint64_t)(DataPtr->Speed) << 37;
+    Fingerprint |= (uint64_t)(DataPtr->Direction & 0x01) << 36;
+    Fingerprint |= (uint64_t)(DataPtr->Occupied) << 35;
+    Fingerprint |= (uint64_t)(DataPtr->Functions & 0x1FFFFFFF);
+
+    return (Fingerprint);
+}
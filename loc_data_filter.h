@@ -0,0 +1,64 @@
+/**
+ **********************************************************************************************************************
+ * @file  loc_data_filter.h
+ * @brief Detection of unchanged loc data responses before they are dispatched to the application.
+ ***********************************************************************************************************************
+ */
+#ifndef LOC_DATA_FILTER_H
+#define LOC_DATA_FILTER_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+#include "xmc_event.h"
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class LocDataFilter
+{
+public:
+    /**
+     * Constructor.
+     */
+    LocDataFilter();
+
+    /**
+     * Check received loc data. Returns true if the data differs from the previous dispatched data, a forced update
+     * was requested or the previous dispatched data is older than the refresh time.
+     */
+    bool Check(const locData* DataPtr, uint32_t TimeStamp);
+
+    /**
+     * Next received loc data is always dispatched.
+     */
+    void Force(void);
+
+    /**
+     * Get number of received loc data responses.
+     */
+    uint32_t ReceivedGet(void);
+
+    /**
+     * Get number of dropped loc data responses.
+     */
+    uint32_t DroppedGet(void);
+
+private:
+    /**
+     * Pack all loc data in one value so unchanged data can be detected with a single compare.
+     */
+    uint64_t FingerprintGet(const locData* DataPtr);
+
+    static const uint32_t REFRESH_TIME = 5000;
+
+    uint64_t m_Fingerprint;
+    uint32_t m_TimeStamp;
+    bool m_Valid;
+    bool m_Force;
+    uint32_t m_Received;
+    uint32_t m_Dropped;
+};
+
+#endif
@@ -0,0 +1,103 @@
+/***********************************************************************************************************************
+   @file   loc_state_cache.cpp
+   @brief  Cache with the last known loc data of recently controlled locs.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "loc_state_cache.h"
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+LocStateCache::LocStateCache() { Clear(); }
+
+/***********************************************************************************************************************
+ */
+void LocStateCache::Clear(void)
+{
+    uint8_t Index;
+
+    for (Index = 0; Index < CACHE_SIZE; Index++)
+    {
+        m_Entries[Index].Valid = false;
+    }
+}
+
+/***********************************************************************************************************************
+ */
+void LocStateCache::Store(const locData* DataPtr, uint32_t TimeStamp)
+{
+    uint8_t Index;
+    uint8_t IndexStore = 0;
+
+    for (Index = 0; Index < CACHE_SIZE; Index++)
+    {
+        if ((m_Entries[Index].Valid == true) && (m_Entries[Index].Data.Address == DataPtr->Address))
+        {
+            /* Loc already present, refresh it. */
+            IndexStore = Index;
+            break;
+        }
+        else if (m_Entries[Index].Valid == false)
+        {
+            /* Free entry, keep looking for the loc itself. */
+            if (m_Entries[IndexStore].Valid == true)
+            {
+                IndexStore = Index;
+            }
+        }
+        else if ((m_Entries[IndexStore].Valid == true)
+            && ((TimeStamp - m_Entries[Index].TimeStamp) > (TimeStamp - m_Entries[IndexStore].TimeStamp)))
+        {
+            /* Oldest entry so far. */
+            IndexStore = Index;
+        }
+    }
+
+    memcpy(&m_Entries[IndexStore].Data, DataPtr, sizeof(locData));
+    m_Entries[IndexStore].TimeStamp = TimeStamp;
+    m_Entries[IndexStore].Valid     = true;
+}
+
+/***********************************************************************************************************************
+ */
+bool LocStateCache::Get(uint16_t Address, locData* DataPtr, uint32_t TimeStamp, uint32_t MaxAge)
+{
+    uint8_t Index;
+    bool Result = false;
+
+    for (Index = 0; Index < CACHE_SIZE; Index++)
+    {
+        if ((m_Entries[Index].Valid == true) && (m_Entries[Index].Data.Address == Address))
+        {
+            if ((TimeStamp - m_Entries[Index].TimeStamp) <= MaxAge)
+            {
+                memcpy(DataPtr, &m_Entries[Index].Data, sizeof(locData));
+                Result = true;
+            }
+            break;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+void LocStateCache::Invalidate(uint16_t Address)
+{
+    uint8_t Index;
+
+    for (Index = 0; Index < CACHE_SIZE; Index++)
+    {
+        if ((m_Entries[Index].Valid == true) && (m_Entries[Index].Data.Address == Address))
+        {
+            m_Entries[Index].Valid = false;
+        }
+    }
+}
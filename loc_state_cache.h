@@ -0,0 +1,63 @@
+/**
+ **********************************************************************************************************************
+ * @file  loc_state_cache.h
+ * @brief Cache with the last known loc data of recently controlled locs.
+ ***********************************************************************************************************************
+ */
+#ifndef LOC_STATE_CACHE_H
+#define LOC_STATE_CACHE_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+#include "xmc_event.h"
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class LocStateCache
+{
+public:
+    /**
+     * Constructor.
+     */
+    LocStateCache();
+
+    /**
+     * Invalidate all entries.
+     */
+    void Clear(void);
+
+    /**
+     * Store (or refresh) the loc data of a loc. If the loc is not present the oldest entry is replaced.
+     */
+    void Store(const locData* DataPtr, uint32_t TimeStamp);
+
+    /**
+     * Get the cached loc data of a loc. Returns false if not present or older than MaxAge msec.
+     */
+    bool Get(uint16_t Address, locData* DataPtr, uint32_t TimeStamp, uint32_t MaxAge);
+
+    /**
+     * Remove a loc from the cache.
+     */
+    void Invalidate(uint16_t Address);
+
+private:
+    /**
+     * Cache entry.
+     */
+    struct cacheEntry
+    {
+        locData Data;
+        uint32_t TimeStamp;
+        bool Valid;
+    };
+
+    static const uint8_t CACHE_SIZE = 16;
+
+    cacheEntry m_Entries[CACHE_SIZE];
+};
+
+#endif
@@ -0,0 +1,67 @@
+/***********************************************************************************************************************
+   @file   poll_rate.cpp
+   @brief  Adapt the rate of periodic XpNet requests to the load of the bus.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "poll_rate.h"
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+PollRate::PollRate(uint8_t SkipMin, uint8_t SkipMax, uint32_t RttTarget)
+{
+    m_SkipMin   = SkipMin;
+    m_SkipMax   = SkipMax;
+    m_Skip      = SkipMin;
+    m_RttTarget = RttTarget;
+    m_Backoff   = 0;
+}
+
+/***********************************************************************************************************************
+ */
+void PollRate::Sample(uint32_t Rtt)
+{
+    if (Rtt > m_RttTarget)
+    {
+        Backoff();
+    }
+    else if (m_Skip > m_SkipMin)
+    {
+        m_Skip--;
+    }
+}
+
+/***********************************************************************************************************************
+ */
+void PollRate::Missed(void) { Backoff(); }
+
+/***********************************************************************************************************************
+ */
+uint8_t PollRate::SkipGet(void) { return (m_Skip); }
+
+/***********************************************************************************************************************
+ */
+uint16_t PollRate::BackoffGet(void) { return (m_Backoff); }
+
+/***********************************************************************************************************************
+ */
+void PollRate::Backoff(void)
+{
+    uint16_t Skip;
+
+    /* Interval is Skip + 1 ticks, doubling the interval. */
+    Skip = ((uint16_t)(m_Skip) + 1) * 2 - 1;
+    if (Skip > m_SkipMax)
+    {
+        Skip = m_SkipMax;
+    }
+
+    m_Skip = (uint8_t)(Skip);
+    m_Backoff++;
+}
@@ -0,0 +1,61 @@
+/**
+ **********************************************************************************************************************
+ * @file  poll_rate.h
+ * @brief Adapt the rate of periodic XpNet requests to the load of the bus.
+ ***********************************************************************************************************************
+ */
+#ifndef POLL_RATE_H
+#define POLL_RATE_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class PollRate
+{
+public:
+    /**
+     * Constructor. The poll interval is expressed in update ticks to skip between two requests, SkipMin is the
+     * interval of an idle bus.
+     */
+    PollRate(uint8_t SkipMin, uint8_t SkipMax, uint32_t RttTarget);
+
+    /**
+     * Handle the round trip time of an answered request. A slow response doubles the interval, a fast response
+     * shortens it by one tick.
+     */
+    void Sample(uint32_t Rtt);
+
+    /**
+     * A request was not answered, double the interval.
+     */
+    void Missed(void);
+
+    /**
+     * Get the number of ticks to skip before the next request.
+     */
+    uint8_t SkipGet(void);
+
+    /**
+     * Get the number of times the interval was increased.
+     */
+    uint16_t BackoffGet(void);
+
+private:
+    /**
+     * Double the interval.
+     */
+    void Backoff(void);
+
+    uint8_t m_SkipMin;
+    uint8_t m_SkipMax;
+    uint8_t m_Skip;
+    uint32_t m_RttTarget;
+    uint16_t m_Backoff;
+};
+
+#endif
@@ -0,0 +1,102 @@
+/***********************************************************************************************************************
+   @file   pom_queue.cpp
+   @brief  Queue for POM (program on main) CV writes which combines writes to the same CV.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "pom_queue.h"
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+PomQueue::PomQueue()
+{
+    m_Added    = 0;
+    m_Sent     = 0;
+    m_Combined = 0;
+    Clear();
+}
+
+/***********************************************************************************************************************
+ */
+void PomQueue::Clear(void) { m_Number = 0; }
+
+/***********************************************************************************************************************
+ */
+bool PomQueue::Add(uint16_t Address, uint16_t CvNumber, uint8_t CvValue)
+{
+    uint8_t Index;
+    bool Result = false;
+
+    for (Index = 0; Index < m_Number; Index++)
+    {
+        if ((m_Entries[Index].Address == Address) && (m_Entries[Index].CvNumber == CvNumber))
+        {
+            /* Same CV still queued, only the last value has to be sent. */
+            m_Entries[Index].CvValue = CvValue;
+            m_Added++;
+            m_Combined++;
+            Result = true;
+            break;
+        }
+    }
+
+    if ((Result == false) && (m_Number < QUEUE_SIZE))
+    {
+        m_Entries[m_Number].Address  = Address;
+        m_Entries[m_Number].CvNumber = CvNumber;
+        m_Entries[m_Number].CvValue  = CvValue;
+        m_Number++;
+        m_Added++;
+        Result = true;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool PomQueue::Next(uint16_t* AddressPtr, uint16_t* CvNumberPtr, uint8_t* CvValuePtr)
+{
+    uint8_t Index;
+    bool Result = false;
+
+    if (m_Number > 0)
+    {
+        *AddressPtr  = m_Entries[0].Address;
+        *CvNumberPtr = m_Entries[0].CvNumber;
+        *CvValuePtr  = m_Entries[0].CvValue;
+
+        m_Number--;
+        for (Index = 0; Index < m_Number; Index++)
+        {
+            m_Entries[Index] = m_Entries[Index + 1];
+        }
+
+        m_Sent++;
+        Result = true;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool PomQueue::Pending(void) { return (m_Number > 0); }
+
+/***********************************************************************************************************************
+ */
+uint16_t PomQueue::AddedGet(void) { return (m_Added); }
+
+/***********************************************************************************************************************
+ */
+uint16_t PomQueue::SentGet(void) { return (m_Sent); }
+
+/***********************************************************************************************************************
+ */
+uint16_t PomQueue::CombinedGet(void) { return (m_Combined); }
@@ -0,0 +1,73 @@
+/**
+ **********************************************************************************************************************
+ * @file  pom_queue.h
+ * @brief Queue for POM (program on main) CV writes which combines writes to the same CV.
+ ***********************************************************************************************************************
+ */
+#ifndef POM_QUEUE_H
+#define POM_QUEUE_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class PomQueue
+{
+public:
+    /**
+     * Constructor.
+     */
+    PomQueue();
+
+    /**
+     * Remove all queued writes, the counters are kept.
+     */
+    void Clear(void);
+
+    /**
+     * Queue a write. A queued write of the same loc and CV only gets the new value. Returns false if the queue is full.
+     */
+    bool Add(uint16_t Address, uint16_t CvNumber, uint8_t CvValue);
+
+    /**
+     * Get and remove the oldest queued write. Returns false if the queue is empty.
+     */
+    bool Next(uint16_t* AddressPtr, uint16_t* CvNumberPtr, uint8_t* CvValuePtr);
+
+    /**
+     * Check if writes are queued.
+     */
+    bool Pending(void);
+
+    /**
+     * Statistics.
+     */
+    uint16_t AddedGet(void);
+    uint16_t SentGet(void);
+    uint16_t CombinedGet(void);
+
+private:
+    static const uint8_t QUEUE_SIZE = 8;
+
+    /**
+     * Queued write.
+     */
+    struct pomEntry
+    {
+        uint16_t Address;
+        uint16_t CvNumber;
+        uint8_t CvValue;
+    };
+
+    pomEntry m_Entries[QUEUE_SIZE];
+    uint8_t m_Number;
+    uint16_t m_Added;
+    uint16_t m_Sent;
+    uint16_t m_Combined;
+};
+
+#endif
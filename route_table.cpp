@@ -0,0 +1,95 @@
+/***********************************************************************************************************************
+   @file   route_table.cpp
+   @brief  Routes (sequences of turnout positions) stored in EEPROM, one page per route.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "route_table.h"
+#include <stddef.h>
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+RouteTable::RouteTable() { m_EepPtr = NULL; }
+
+/***********************************************************************************************************************
+ */
+void RouteTable::Init(EepI2c& Eep) { m_EepPtr = &Eep; }
+
+/***********************************************************************************************************************
+ */
+bool RouteTable::Load(uint8_t Index, route* RoutePtr)
+{
+    bool Result = false;
+    routeRecord Record;
+
+    memset(RoutePtr, 0, sizeof(route));
+
+    /* A route occupies one page so it is read in one page read. */
+    if ((m_EepPtr != NULL) && (Index < ROUTES_MAX)
+        && (m_EepPtr->Read(EepCfg::RouteAddress + (Index * EepCfg::EepromPageSize), (uint8_t*)(&Record),
+                sizeof(routeRecord))
+            == true))
+    {
+        if ((Record.Version == EepCfg::RouteVersion) && (Record.Steps <= STEPS_MAX)
+            && (Record.Crc == EepI2c::Crc16((uint8_t*)(&Record), offsetof(routeRecord, Crc))))
+        {
+            memcpy(RoutePtr->Name, Record.Name, NAME_LENGTH);
+            memcpy(RoutePtr->Step, Record.Step, Record.Steps * sizeof(uint16_t));
+            RoutePtr->Steps = Record.Steps;
+            Result          = true;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool RouteTable::Store(uint8_t Index, const route* RoutePtr)
+{
+    bool Result = false;
+    routeRecord Record;
+
+    if ((m_EepPtr != NULL) && (Index < ROUTES_MAX) && (RoutePtr->Steps <= STEPS_MAX))
+    {
+        memset(&Record, 0, sizeof(routeRecord));
+        Record.Version = EepCfg::RouteVersion;
+        Record.Steps   = RoutePtr->Steps;
+        memcpy(Record.Name, RoutePtr->Name, NAME_LENGTH);
+        memcpy(Record.Step, RoutePtr->Step, RoutePtr->Steps * sizeof(uint16_t));
+        Record.Crc = EepI2c::Crc16((uint8_t*)(&Record), offsetof(routeRecord, Crc));
+
+        Result = m_EepPtr->WriteAsync(
+            EepCfg::RouteAddress + (Index * EepCfg::EepromPageSize), (uint8_t*)(&Record), sizeof(routeRecord));
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+uint16_t RouteTable::StepAddressGet(uint16_t Step) { return (Step & STEP_ADDRESS); }
+
+/***********************************************************************************************************************
+ */
+bool RouteTable::StepTurnGet(uint16_t Step) { return ((Step & STEP_TURN) != 0); }
+
+/***********************************************************************************************************************
+ */
+uint16_t RouteTable::StepSet(uint16_t Address, bool Turn)
+{
+    uint16_t Step = Address & STEP_ADDRESS;
+
+    if (Turn == true)
+    {
+        Step |= STEP_TURN;
+    }
+
+    return (Step);
+}
@@ -0,0 +1,83 @@
+/**
+ **********************************************************************************************************************
+ * @file  route_table.h
+ * @brief Routes (sequences of turnout positions) stored in EEPROM, one page per route.
+ ***********************************************************************************************************************
+ */
+#ifndef ROUTE_TABLE_H
+#define ROUTE_TABLE_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include "eep_cfg.h"
+#include "eep_i2c.h"
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class RouteTable
+{
+public:
+    static const uint8_t ROUTES_MAX  = 16;
+    static const uint8_t STEPS_MAX   = 25;
+    static const uint8_t NAME_LENGTH = 10;
+
+    /**
+     * Route, each step holds the turnout address in bit 0..13 and the direction in bit 15 (set is turn).
+     */
+    struct route
+    {
+        char Name[NAME_LENGTH + 1];
+        uint8_t Steps;
+        uint16_t Step[STEPS_MAX];
+    };
+
+    /**
+     * Constructor.
+     */
+    RouteTable();
+
+    /**
+     * Set the EEPROM used for the routes.
+     */
+    void Init(EepI2c& Eep);
+
+    /**
+     * Read a route, an empty route is returned when the route was never stored or is corrupt.
+     */
+    bool Load(uint8_t Index, route* RoutePtr);
+
+    /**
+     * Store a route, written in the background.
+     */
+    bool Store(uint8_t Index, const route* RoutePtr);
+
+    /**
+     * Step access.
+     */
+    static uint16_t StepAddressGet(uint16_t Step);
+    static bool StepTurnGet(uint16_t Step);
+    static uint16_t StepSet(uint16_t Address, bool Turn);
+
+private:
+    static const uint16_t STEP_TURN    = 0x8000;
+    static const uint16_t STEP_ADDRESS = 0x3FFF;
+
+    /**
+     * Route as stored in EEPROM, exactly one page.
+     */
+    struct routeRecord
+    {
+        uint8_t Version;
+        uint8_t Steps;
+        char Name[NAME_LENGTH];
+        uint16_t Step[STEPS_MAX];
+        uint16_t Crc;
+    };
+
+    EepI2c* m_EepPtr;
+};
+
+#endif
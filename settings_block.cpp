@@ -0,0 +1,181 @@
+/***********************************************************************************************************************
+   @file   settings_block.cpp
+   @brief  RAM copy of the settings, read from EEPROM in one burst and protected with a CRC.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "settings_block.h"
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+SettingsBlock::SettingsBlock()
+{
+    m_EepPtr            = NULL;
+    m_StoragePtr        = NULL;
+    m_XpNetAddress      = 255;
+    m_EmergencyOption   = false;
+    m_PulseSwitchInvert = false;
+    m_AcOption          = 0;
+    m_AutoOff           = 0;
+    m_TurnoutPulseTime  = 0xFF;
+}
+
+/***********************************************************************************************************************
+ */
+void SettingsBlock::Load(EepI2c& Eep, LocStorage& Storage)
+{
+    settingsHeader Header;
+
+    m_EepPtr     = &Eep;
+    m_StoragePtr = &Storage;
+
+    if ((ReadArea(&Header) == true) && (Header.Version == EepCfg::SettingsVersion)
+        && (Header.Crc == CrcGet()))
+    {
+        m_XpNetAddress      = m_Area[EepCfg::XpNetAddress];
+        m_EmergencyOption   = (m_Area[EepCfg::EmergencyStopEnabledAddress] != 0);
+        m_PulseSwitchInvert = (m_Area[EepCfg::PulseSwitchInvertAddress] != 0);
+        m_AcOption          = m_Area[EepCfg::AcTypeControlAddress];
+        m_AutoOff           = m_Area[EepCfg::AutoOffAddress];
+    }
+    else
+    {
+        m_XpNetAddress      = m_StoragePtr->XpNetAddressGet();
+        m_EmergencyOption   = m_StoragePtr->EmergencyOptionGet();
+        m_PulseSwitchInvert = m_StoragePtr->PulseSwitchInvertGet();
+        m_AcOption          = m_StoragePtr->AcOptionGet();
+        m_AutoOff           = 0;
+        Commit();
+    }
+
+    /* Own address behind the settings header, not written by the loc storage. */
+    if (m_EepPtr->Read(EepCfg::TurnoutPulseTimeAddress, &m_TurnoutPulseTime, 1) == false)
+    {
+        m_TurnoutPulseTime = 0xFF;
+    }
+}
+
+/***********************************************************************************************************************
+ */
+bool SettingsBlock::Commit(void)
+{
+    bool Result = false;
+    settingsHeader Header;
+
+    /* Only protect the area with a CRC when it holds the settings as single bytes, otherwise the loc storage getters
+     * keep being used at start up. */
+    if ((m_EepPtr != NULL) && (ReadArea(&Header) == true) && (m_Area[EepCfg::XpNetAddress] == m_XpNetAddress)
+        && ((m_Area[EepCfg::EmergencyStopEnabledAddress] != 0) == m_EmergencyOption)
+        && ((m_Area[EepCfg::PulseSwitchInvertAddress] != 0) == m_PulseSwitchInvert))
+    {
+        Header.Version  = EepCfg::SettingsVersion;
+        Header.Reserved = 0;
+        Header.Crc      = CrcGet();
+        Result = m_EepPtr->WriteAsync(EepCfg::SettingsHeaderAddress, (uint8_t*)(&Header), sizeof(settingsHeader));
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+uint8_t SettingsBlock::XpNetAddressGet(void) { return (m_XpNetAddress); }
+
+/***********************************************************************************************************************
+ */
+void SettingsBlock::XpNetAddressSet(uint8_t Address)
+{
+    /* Always write, the RAM copy may differ from the EEPROM when the loc storage changed it. */
+    m_XpNetAddress = Address;
+    m_EepPtr->Flush();
+    m_StoragePtr->XpNetAddressSet(Address);
+}
+
+/***********************************************************************************************************************
+ */
+bool SettingsBlock::EmergencyOptionGet(void) { return (m_EmergencyOption); }
+
+/***********************************************************************************************************************
+ */
+void SettingsBlock::EmergencyOptionSet(bool Enabled)
+{
+    m_EmergencyOption = Enabled;
+    m_EepPtr->Flush();
+    m_StoragePtr->EmergencyOptionSet((Enabled == true) ? 1 : 0);
+}
+
+/***********************************************************************************************************************
+ */
+bool SettingsBlock::PulseSwitchInvertGet(void) { return (m_PulseSwitchInvert); }
+
+/***********************************************************************************************************************
+ */
+uint8_t SettingsBlock::AcOptionGet(void) { return (m_AcOption); }
+
+/***********************************************************************************************************************
+ */
+void SettingsBlock::AcOptionSet(uint8_t Option)
+{
+    m_AcOption = Option;
+    m_EepPtr->Flush();
+    m_StoragePtr->AcOptionSet(Option);
+}
+
+/***********************************************************************************************************************
+ */
+uint8_t SettingsBlock::AutoOffGet(void) { return (m_AutoOff); }
+
+/***********************************************************************************************************************
+ */
+uint8_t SettingsBlock::TurnoutPulseTimeGet(void) { return (m_TurnoutPulseTime); }
+
+/***********************************************************************************************************************
+ */
+void SettingsBlock::TurnoutPulseTimeSet(uint8_t PulseTime)
+{
+    if (m_TurnoutPulseTime != PulseTime)
+    {
+        m_TurnoutPulseTime = PulseTime;
+        m_EepPtr->WriteAsync(EepCfg::TurnoutPulseTimeAddress, &m_TurnoutPulseTime, 1);
+    }
+}
+
+/***********************************************************************************************************************
+ */
+uint16_t SettingsBlock::CrcGet(void)
+{
+    uint8_t Index;
+    uint16_t Crc                            = 0xFFFF;
+    const int SettingsAddress[SETTINGS_NUM] = { EepCfg::AcTypeControlAddress, EepCfg::XpNetAddress,
+        EepCfg::EmergencyStopEnabledAddress, EepCfg::PulseSwitchInvertAddress, EepCfg::AutoOffAddress };
+
+    /* Number of locs and selected loc in the same area change during use and are not part of the settings. Each
+     * setting occupies two bytes. */
+    for (Index = 0; Index < SETTINGS_NUM; Index++)
+    {
+        Crc = EepI2c::Crc16(&m_Area[SettingsAddress[Index]], 2, Crc);
+    }
+
+    return (Crc);
+}
+
+/***********************************************************************************************************************
+ */
+bool SettingsBlock::ReadArea(settingsHeader* HeaderPtr)
+{
+    bool Result;
+    uint8_t Data[SETTINGS_SIZE + sizeof(settingsHeader)];
+
+    /* Settings area and header directly behind it in one sequential read. */
+    Result = m_EepPtr->Read(0, Data, sizeof(Data));
+    memcpy(m_Area, Data, SETTINGS_SIZE);
+    memcpy(HeaderPtr, &Data[SETTINGS_SIZE], sizeof(settingsHeader));
+
+    return (Result);
+}
@@ -0,0 +1,92 @@
+/**
+ **********************************************************************************************************************
+ * @file  settings_block.h
+ * @brief RAM copy of the settings, read from EEPROM in one burst and protected with a CRC.
+ ***********************************************************************************************************************
+ */
+#ifndef SETTINGS_BLOCK_H
+#define SETTINGS_BLOCK_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include "LocStorage.h"
+#include "eep_cfg.h"
+#include "eep_i2c.h"
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class SettingsBlock
+{
+public:
+    /**
+     * Constructor.
+     */
+    SettingsBlock();
+
+    /**
+     * Read the settings area and header in one burst. If the CRC does not match (first start or settings changed by
+     * the loc storage itself, for example by the command line interface) the settings are read with the loc storage
+     * getters and the header is updated.
+     */
+    void Load(EepI2c& Eep, LocStorage& Storage);
+
+    /**
+     * Store the header with the CRC of the actual settings area. Call after (a group of) settings is changed. Returns
+     * false when the area does not hold the cached settings as single bytes, the header is not written then and the
+     * next Load() uses the loc storage getters.
+     */
+    bool Commit(void);
+
+    /**
+     * Cached settings.
+     */
+    uint8_t XpNetAddressGet(void);
+    void XpNetAddressSet(uint8_t Address);
+    bool EmergencyOptionGet(void);
+    void EmergencyOptionSet(bool Enabled);
+    bool PulseSwitchInvertGet(void);
+    uint8_t AcOptionGet(void);
+    void AcOptionSet(uint8_t Option);
+    uint8_t AutoOffGet(void);
+    uint8_t TurnoutPulseTimeGet(void);
+    void TurnoutPulseTimeSet(uint8_t PulseTime);
+
+private:
+    /**
+     * Header directly after the settings area.
+     */
+    struct settingsHeader
+    {
+        uint8_t Version;
+        uint8_t Reserved;
+        uint16_t Crc;
+    };
+
+    /**
+     * CRC of the settings in the settings area.
+     */
+    uint16_t CrcGet(void);
+
+    /**
+     * Read settings area and header.
+     */
+    bool ReadArea(settingsHeader* HeaderPtr);
+
+    static const uint8_t SETTINGS_SIZE = EepCfg::SettingsHeaderAddress;
+    static const uint8_t SETTINGS_NUM  = 5;
+
+    EepI2c* m_EepPtr;
+    LocStorage* m_StoragePtr;
+    uint8_t m_Area[SETTINGS_SIZE];
+    uint8_t m_XpNetAddress;
+    bool m_EmergencyOption;
+    bool m_PulseSwitchInvert;
+    uint8_t m_AcOption;
+    uint8_t m_AutoOff;
+    uint8_t m_TurnoutPulseTime;
+};
+
+#endif
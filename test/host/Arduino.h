@@ -0,0 +1,32 @@
+/**
+ **********************************************************************************************************************
+ * @file  Arduino.h
+ * @brief Minimal Arduino environment to build application modules on the host. Time is taken from the simulated
+ *        clock of the EEPROM simulator.
+ ***********************************************************************************************************************
+ */
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/***********************************************************************************************************************
+ * F U N C T I O N S
+ **********************************************************************************************************************/
+
+/**
+ * Simulated time since start in msec.
+ */
+uint32_t millis(void);
+
+/**
+ * Simulated time since start in usec.
+ */
+uint32_t micros(void);
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ **********************************************************************************************************************
+ * @file  Wire.h
+ * @brief Arduino I2C interface on the host, the only connected device is the simulated 24LC256 EEPROM.
+ ***********************************************************************************************************************
+ */
+#ifndef WIRE_H
+#define WIRE_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * D E F I N E S
+ **********************************************************************************************************************/
+#define BUFFER_LENGTH 32
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class TwoWire
+{
+public:
+    /**
+     * Constructor.
+     */
+    TwoWire();
+
+    /**
+     * Init the bus, standard mode (100 kHz).
+     */
+    void begin(void);
+
+    /**
+     * Set the bus clock frequency.
+     */
+    void setClock(uint32_t Frequency);
+
+    /**
+     * Start collecting the bytes of a transmission.
+     */
+    void beginTransmission(uint8_t Address);
+
+    /**
+     * Add data to the transmission, returns the number of bytes which fitted in the buffer.
+     */
+    size_t write(uint8_t Data);
+    size_t write(const uint8_t* DataPtr, size_t Length);
+
+    /**
+     * Transmit the collected bytes. Returns 0 on success, 2 when the address is not acknowledged.
+     */
+    uint8_t endTransmission(bool Stop = true);
+
+    /**
+     * Read bytes from the device, returns the number of bytes received.
+     */
+    uint8_t requestFrom(uint8_t Address, uint8_t Length);
+
+    /**
+     * Access the received bytes.
+     */
+    int available(void);
+    int read(void);
+
+private:
+    uint8_t m_TxAddress;
+    uint8_t m_TxBuffer[BUFFER_LENGTH];
+    uint8_t m_TxCnt;
+    uint8_t m_RxBuffer[BUFFER_LENGTH];
+    uint8_t m_RxCnt;
+    uint8_t m_RxIndex;
+};
+
+extern TwoWire Wire;
+
+#endif
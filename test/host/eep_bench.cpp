@@ -0,0 +1,280 @@
+/***********************************************************************************************************************
+   @file   eep_bench.cpp
+   @brief  Host checks and stall benchmark of the EEPROM write engine against the simulated 24LC256.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "eep_cfg.h"
+#include "eep_i2c.h"
+#include "eep_sim.h"
+#include <stdio.h>
+
+/***********************************************************************************************************************
+   D E F I N E S
+ **********************************************************************************************************************/
+#define CHECK(Condition) Check((Condition), #Condition, __LINE__)
+
+/***********************************************************************************************************************
+   E X P O R T E D   V A R I A B L E S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   L O C A L   V A R I A B L E S
+ **********************************************************************************************************************/
+
+/**
+ * Way the application writes the EEPROM.
+ */
+enum benchMode
+{
+    modeWrite = 0,       /* Blocking write in the event handler. */
+    modeWriteAsyncFlush, /* Queued write, flushed on each 100 msec tick. */
+    modeWriteAsync,      /* Queued write, written by Update() in the main loop. */
+};
+
+/**
+ * Application data written during the benchmark.
+ */
+struct benchBlock
+{
+    const char* Name;
+    uint16_t Address;
+    uint8_t Length;
+    uint32_t Period;
+    uint32_t Offset;
+    uint8_t Data[EepCfg::EepromPageSize];
+};
+
+static const uint32_t BENCH_TIME = 60000; /* Simulated msec. */
+static const uint32_t TICK_TIME  = 100;   /* Application tick msec. */
+static const uint32_t LOOP_USEC  = 1000;  /* Time of the rest of the main loop. */
+
+static benchBlock benchBlocks[] = {
+    { "snapshot", EepCfg::SnapshotAddress, 10, 3000, 0, { 0 } },
+    { "route", EepCfg::RouteAddress, 64, 5000, 1000, { 0 } },
+    { "cv backup", EepCfg::CvBackupAddress + EepCfg::EepromPageSize, 64, 10000, 2000, { 0 } },
+    { "settings", EepCfg::SettingsHeaderAddress, 4, 7000, 500, { 0 } },
+    { "pulse time", EepCfg::TurnoutPulseTimeAddress, 1, 7000, 500, { 0 } },
+};
+
+static const char* benchModeNames[] = { "Write", "WriteAsync + Flush per tick", "WriteAsync + Update" };
+
+static uint16_t checkFailed = 0;
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Report a failed check.
+ */
+static void Check(bool Condition, const char* TextPtr, int Line)
+{
+    if (Condition == false)
+    {
+        printf("FAILED line %d: %s\n", Line, TextPtr);
+        checkFailed++;
+    }
+}
+
+/***********************************************************************************************************************
+ * Compare the simulated EEPROM content with data.
+ */
+static bool MemoryEqual(uint16_t Address, const uint8_t* DataPtr, uint16_t Length)
+{
+    bool Result = true;
+    uint16_t Index;
+
+    for (Index = 0; Index < Length; Index++)
+    {
+        if (EepSim::MemoryGet(Address + Index) != DataPtr[Index])
+        {
+            Result = false;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Check the write engine against the simulated EEPROM.
+ */
+static void CheckWriteEngine(void)
+{
+    EepI2c Eep;
+    uint8_t Data[100];
+    uint8_t ReadData[100];
+    uint16_t Index;
+    uint32_t Start;
+
+    for (Index = 0; Index < sizeof(Data); Index++)
+    {
+        Data[Index] = (uint8_t)(Index + 1);
+    }
+
+    /* Blocking write across page boundaries in chunks of 4, 30, 30, 4, 30 and 2 bytes, each waits for its cycle. */
+    EepSim::Reset();
+    Eep.Init();
+    CHECK(Eep.Write(60, Data, sizeof(Data)) == true);
+    CHECK(MemoryEqual(60, Data, sizeof(Data)) == true);
+    CHECK(EepSim::PageWritesGet() == 6);
+    CHECK(EepSim::ClockGet() >= (6 * EepSim::WRITE_CYCLE_USEC));
+    CHECK(Eep.Read(60, ReadData, sizeof(Data)) == true);
+    CHECK(memcmp(ReadData, Data, sizeof(Data)) == 0);
+
+    /* Queued data is read back before it is written. */
+    EepSim::Reset();
+    Eep.Init();
+    CHECK(Eep.WriteAsync(200, Data, 20) == true);
+    CHECK(EepSim::PageWritesGet() == 0);
+    memset(ReadData, 0, sizeof(ReadData));
+    CHECK(Eep.Read(190, ReadData, 40) == true);
+    CHECK(ReadData[0] == 0xFF);
+    CHECK(memcmp(&ReadData[10], Data, 20) == 0);
+    CHECK(ReadData[30] == 0xFF);
+
+    /* Update starts a page write without waiting, a second Update does not wait for the write cycle. */
+    Start = EepSim::ClockGet();
+    Eep.Update();
+    CHECK(EepSim::PageWritesGet() == 1);
+    CHECK(MemoryEqual(200, Data, 20) == true);
+    Eep.Update();
+    CHECK((EepSim::ClockGet() - Start) < EepSim::WRITE_CYCLE_USEC);
+
+    /* Reading during the write cycle waits for it. */
+    CHECK(Eep.Read(200, ReadData, 20) == true);
+    CHECK(memcmp(ReadData, Data, 20) == 0);
+
+    /* A queued write of the same block is replaced, the latest data is written. */
+    EepSim::Reset();
+    Eep.Init();
+    CHECK(Eep.WriteAsync(300, Data, 10) == true);
+    CHECK(Eep.WriteAsync(300, &Data[50], 10) == true);
+    CHECK(Eep.Flush() == true);
+    CHECK(EepSim::PageWritesGet() == 1);
+    CHECK(MemoryEqual(300, &Data[50], 10) == true);
+
+    /* A full queue writes the oldest page first. */
+    EepSim::Reset();
+    Eep.Init();
+    for (Index = 0; Index < 5; Index++)
+    {
+        CHECK(Eep.WriteAsync(Index * EepCfg::EepromPageSize, &Data[Index], 8) == true);
+    }
+    CHECK(Eep.QueueFullGet() == 1);
+    CHECK(EepSim::PageWritesGet() == 1);
+    CHECK(MemoryEqual(0, &Data[0], 8) == true);
+    CHECK(Eep.Flush() == true);
+    for (Index = 0; Index < 5; Index++)
+    {
+        CHECK(MemoryEqual(Index * EepCfg::EepromPageSize, &Data[Index], 8) == true);
+    }
+
+    /* A blocking write after a queued write of the same address keeps the order. */
+    EepSim::Reset();
+    Eep.Init();
+    CHECK(Eep.WriteAsync(400, Data, 10) == true);
+    CHECK(Eep.Write(400, &Data[20], 10) == true);
+    CHECK(Eep.Flush() == true);
+    CHECK(MemoryEqual(400, &Data[20], 10) == true);
+}
+
+/***********************************************************************************************************************
+ * Run the application write load and report the time the main loop is stalled by EEPROM access.
+ */
+static void Benchmark(benchMode Mode)
+{
+    EepI2c Eep;
+    uint32_t Time;
+    uint32_t Start;
+    uint32_t Stall;
+    uint32_t StallMax   = 0;
+    uint32_t StallTotal = 0;
+    uint32_t Loops      = 0;
+    uint32_t TickLast   = 0;
+    uint16_t Block;
+    uint8_t Index;
+
+    EepSim::Reset();
+    Eep.Init();
+
+    while (millis() < BENCH_TIME)
+    {
+        Start = EepSim::ClockGet();
+        Time  = millis();
+
+        if ((Time - TickLast) >= TICK_TIME)
+        {
+            TickLast = Time - (Time % TICK_TIME);
+
+            for (Block = 0; Block < (sizeof(benchBlocks) / sizeof(benchBlock)); Block++)
+            {
+                if ((TickLast % benchBlocks[Block].Period) == benchBlocks[Block].Offset)
+                {
+                    for (Index = 0; Index < benchBlocks[Block].Length; Index++)
+                    {
+                        benchBlocks[Block].Data[Index] = (uint8_t)(TickLast / TICK_TIME) + Index;
+                    }
+
+                    if (Mode == modeWrite)
+                    {
+                        Eep.Write(benchBlocks[Block].Address, benchBlocks[Block].Data, benchBlocks[Block].Length);
+                    }
+                    else
+                    {
+                        Eep.WriteAsync(benchBlocks[Block].Address, benchBlocks[Block].Data, benchBlocks[Block].Length);
+                    }
+                }
+            }
+
+            if (Mode == modeWriteAsyncFlush)
+            {
+                Eep.Flush();
+            }
+        }
+
+        if (Mode != modeWrite)
+        {
+            Eep.Update();
+        }
+
+        Stall = EepSim::ClockGet() - Start;
+        StallTotal += Stall;
+        if (Stall > StallMax)
+        {
+            StallMax = Stall;
+        }
+
+        Loops++;
+        EepSim::ClockAdvance(LOOP_USEC);
+    }
+
+    Eep.Flush();
+    for (Block = 0; Block < (sizeof(benchBlocks) / sizeof(benchBlock)); Block++)
+    {
+        CHECK(MemoryEqual(benchBlocks[Block].Address, benchBlocks[Block].Data, benchBlocks[Block].Length) == true);
+    }
+
+    printf("%-28s %6u %8u %10u %10u %8u\n", benchModeNames[Mode], (unsigned)Eep.PagesWrittenGet(), (unsigned)Loops,
+        (unsigned)(StallTotal / 1000), (unsigned)StallMax, (unsigned)(Eep.WaitTimeGet() / 1000));
+}
+
+/***********************************************************************************************************************
+ */
+int main(void)
+{
+    CheckWriteEngine();
+
+    printf("24LC256 at 100 kHz, write cycle %u usec, %u sec application load.\n",
+        (unsigned)EepSim::WRITE_CYCLE_USEC, (unsigned)(BENCH_TIME / 1000));
+    printf("%-28s %6s %8s %10s %10s %8s\n", "mode", "pages", "loops", "stall ms", "max usec", "wait ms");
+    Benchmark(modeWrite);
+    Benchmark(modeWriteAsyncFlush);
+    Benchmark(modeWriteAsync);
+
+    printf("%s\n", (checkFailed == 0) ? "All checks passed." : "Checks FAILED.");
+
+    return ((checkFailed == 0) ? 0 : 1);
+}
@@ -0,0 +1,244 @@
+/***********************************************************************************************************************
+   @file   eep_sim.cpp
+   @brief  Host simulation of the 24LC256 I2C EEPROM including the bus transfer time and the internal write cycle.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "eep_sim.h"
+#include <Wire.h>
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+uint8_t EepSim::m_Memory[EepSim::SIZE];
+uint16_t EepSim::m_Pointer    = 0;
+uint32_t EepSim::m_Clock      = 0;
+uint32_t EepSim::m_BusyUntil  = 0;
+uint32_t EepSim::m_WriteCycle = EepSim::WRITE_CYCLE_USEC;
+uint32_t EepSim::m_ByteTime   = 90;
+uint32_t EepSim::m_PageWrites = 0;
+uint32_t EepSim::m_Nack       = 0;
+
+TwoWire Wire;
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+uint32_t millis(void) { return (EepSim::ClockGet() / 1000); }
+
+/***********************************************************************************************************************
+ */
+uint32_t micros(void) { return (EepSim::ClockGet()); }
+
+/***********************************************************************************************************************
+ */
+void EepSim::Reset(uint32_t WriteCycleUsec)
+{
+    memset(m_Memory, 0xFF, sizeof(m_Memory));
+    m_Pointer    = 0;
+    m_Clock      = 0;
+    m_BusyUntil  = 0;
+    m_WriteCycle = WriteCycleUsec;
+    m_PageWrites = 0;
+    m_Nack       = 0;
+}
+
+/***********************************************************************************************************************
+ */
+void EepSim::BusClockSet(uint32_t Frequency) { m_ByteTime = (9 * 1000000) / Frequency; }
+
+/***********************************************************************************************************************
+ */
+uint32_t EepSim::ClockGet(void) { return (m_Clock); }
+
+/***********************************************************************************************************************
+ */
+void EepSim::ClockAdvance(uint32_t Usec) { m_Clock += Usec; }
+
+/***********************************************************************************************************************
+ */
+uint8_t EepSim::MemoryGet(uint16_t Address) { return (m_Memory[Address % SIZE]); }
+
+/***********************************************************************************************************************
+ */
+bool EepSim::Transmit(uint8_t Address, const uint8_t* DataPtr, uint8_t Length)
+{
+    bool Result = false;
+    uint8_t Index;
+    uint16_t PageStart;
+
+    if ((Address != I2C_ADDRESS) || (Busy() == true))
+    {
+        /* Only the address byte is clocked out. */
+        m_Clock += START_STOP_USEC + m_ByteTime;
+        m_Nack++;
+    }
+    else
+    {
+        m_Clock += START_STOP_USEC + ((1 + Length) * m_ByteTime);
+
+        if (Length >= 2)
+        {
+            m_Pointer = ((DataPtr[0] << 8) | DataPtr[1]) % SIZE;
+        }
+
+        if (Length > 2)
+        {
+            /* Page write, the address counter rolls over within the page. */
+            PageStart = m_Pointer - (m_Pointer % PAGE_SIZE);
+            for (Index = 2; Index < Length; Index++)
+            {
+                m_Memory[m_Pointer] = DataPtr[Index];
+                m_Pointer           = PageStart + ((m_Pointer + 1) % PAGE_SIZE);
+            }
+
+            m_BusyUntil = m_Clock + m_WriteCycle;
+            m_PageWrites++;
+        }
+
+        Result = true;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+bool EepSim::Receive(uint8_t Address, uint8_t* DataPtr, uint8_t Length)
+{
+    bool Result = false;
+    uint8_t Index;
+
+    if ((Address != I2C_ADDRESS) || (Busy() == true))
+    {
+        m_Clock += START_STOP_USEC + m_ByteTime;
+        m_Nack++;
+    }
+    else
+    {
+        /* Sequential read, the address counter rolls over at the end of the memory. */
+        m_Clock += START_STOP_USEC + ((1 + Length) * m_ByteTime);
+        for (Index = 0; Index < Length; Index++)
+        {
+            DataPtr[Index] = m_Memory[m_Pointer];
+            m_Pointer      = (m_Pointer + 1) % SIZE;
+        }
+
+        Result = true;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+uint32_t EepSim::PageWritesGet(void) { return (m_PageWrites); }
+
+/***********************************************************************************************************************
+ */
+uint32_t EepSim::NackGet(void) { return (m_Nack); }
+
+/***********************************************************************************************************************
+ */
+bool EepSim::Busy(void) { return (m_Clock < m_BusyUntil); }
+
+/***********************************************************************************************************************
+ */
+TwoWire::TwoWire()
+{
+    m_TxAddress = 0;
+    m_TxCnt     = 0;
+    m_RxCnt     = 0;
+    m_RxIndex   = 0;
+}
+
+/***********************************************************************************************************************
+ */
+void TwoWire::begin(void) { EepSim::BusClockSet(100000); }
+
+/***********************************************************************************************************************
+ */
+void TwoWire::setClock(uint32_t Frequency) { EepSim::BusClockSet(Frequency); }
+
+/***********************************************************************************************************************
+ */
+void TwoWire::beginTransmission(uint8_t Address)
+{
+    m_TxAddress = Address;
+    m_TxCnt     = 0;
+}
+
+/***********************************************************************************************************************
+ */
+size_t TwoWire::write(uint8_t Data)
+{
+    size_t Result = 0;
+
+    if (m_TxCnt < BUFFER_LENGTH)
+    {
+        m_TxBuffer[m_TxCnt++] = Data;
+        Result                = 1;
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+size_t TwoWire::write(const uint8_t* DataPtr, size_t Length)
+{
+    size_t Index = 0;
+
+    while ((Index < Length) && (write(DataPtr[Index]) == 1))
+    {
+        Index++;
+    }
+
+    return (Index);
+}
+
+/***********************************************************************************************************************
+ */
+uint8_t TwoWire::endTransmission(bool Stop)
+{
+    (void)Stop;
+    return ((EepSim::Transmit(m_TxAddress, m_TxBuffer, m_TxCnt) == true) ? 0 : 2);
+}
+
+/***********************************************************************************************************************
+ */
+uint8_t TwoWire::requestFrom(uint8_t Address, uint8_t Length)
+{
+    if (Length > BUFFER_LENGTH)
+    {
+        Length = BUFFER_LENGTH;
+    }
+
+    m_RxIndex = 0;
+    m_RxCnt   = (EepSim::Receive(Address, m_RxBuffer, Length) == true) ? Length : 0;
+
+    return (m_RxCnt);
+}
+
+/***********************************************************************************************************************
+ */
+int TwoWire::available(void) { return (m_RxCnt - m_RxIndex); }
+
+/***********************************************************************************************************************
+ */
+int TwoWire::read(void)
+{
+    int Result = -1;
+
+    if (m_RxIndex < m_RxCnt)
+    {
+        Result = m_RxBuffer[m_RxIndex++];
+    }
+
+    return (Result);
+}
@@ -0,0 +1,75 @@
+/**
+ **********************************************************************************************************************
+ * @file  eep_sim.h
+ * @brief Host simulation of the 24LC256 I2C EEPROM including the bus transfer time and the internal write cycle.
+ ***********************************************************************************************************************
+ */
+#ifndef EEP_SIM_H
+#define EEP_SIM_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class EepSim
+{
+public:
+    static const uint8_t I2C_ADDRESS       = 0x50;
+    static const uint32_t SIZE             = 32768;
+    static const uint32_t PAGE_SIZE        = 64;
+    static const uint32_t WRITE_CYCLE_USEC = 5000; /* Max write cycle time of the datasheet. */
+
+    /**
+     * Erase the memory (0xFF), reset the clock and the statistics and set the write cycle time.
+     */
+    static void Reset(uint32_t WriteCycleUsec = WRITE_CYCLE_USEC);
+
+    /**
+     * Set the bus clock frequency, the transfer time of a byte is 9 bit clocks.
+     */
+    static void BusClockSet(uint32_t Frequency);
+
+    /**
+     * Simulated time in usec. Application code which is not simulated advances the clock itself.
+     */
+    static uint32_t ClockGet(void);
+    static void ClockAdvance(uint32_t Usec);
+
+    /**
+     * Direct access to the memory content, does not take any time.
+     */
+    static uint8_t MemoryGet(uint16_t Address);
+
+    /**
+     * Bus transaction from the I2C master. Page writes start the internal write cycle, during the write cycle the
+     * device address is not acknowledged.
+     */
+    static bool Transmit(uint8_t Address, const uint8_t* DataPtr, uint8_t Length);
+    static bool Receive(uint8_t Address, uint8_t* DataPtr, uint8_t Length);
+
+    /**
+     * Statistics.
+     */
+    static uint32_t PageWritesGet(void);
+    static uint32_t NackGet(void);
+
+private:
+    static const uint32_t START_STOP_USEC = 10;
+
+    static bool Busy(void);
+
+    static uint8_t m_Memory[SIZE];
+    static uint16_t m_Pointer;
+    static uint32_t m_Clock;
+    static uint32_t m_BusyUntil;
+    static uint32_t m_WriteCycle;
+    static uint32_t m_ByteTime;
+    static uint32_t m_PageWrites;
+    static uint32_t m_Nack;
+};
+
+#endif
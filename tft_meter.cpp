@@ -0,0 +1,128 @@
+/***********************************************************************************************************************
+   @file   tft_meter.cpp
+   @brief  TFT wrapper counting the drawing primitives, pixels and SPI bytes of screen updates.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "tft_meter.h"
+
+/***********************************************************************************************************************
+   D A T A   D E C L A R A T I O N S (exported, local)
+ **********************************************************************************************************************/
+
+/* Estimated area written by each primitive on the 160 * 128 display. */
+const TftMeter::primitiveArea TftMeter::m_Area[primMax] = {
+    { "Init", 160, 128 },
+    { "ShowVersion", 160, 40 },
+    { "Clear", 160, 128 },
+    { "UpdateStatus", 160, 16 },
+    { "ShowXpNetAddress", 80, 24 },
+    { "ShowName", 160, 40 },
+    { "UpdateRunningWheel", 16, 16 },
+    { "UpdateSelectedAndNumberOfLocs", 56, 8 },
+    { "UpdateLocInfoSelect", 160, 40 },
+    { "UpdateLocInfo", 160, 40 },
+    { "UpdateLocInfoAll", 160, 112 },
+    { "ShowTurnoutScreen", 160, 112 },
+    { "ShowTurnoutAddress", 96, 24 },
+    { "ShowTurnoutDirection", 64, 64 },
+    { "ShowMenu1", 160, 112 },
+    { "ShowMenu2", 160, 112 },
+    { "ShowErase", 160, 112 },
+    { "ShowLocSymbolFw", 64, 32 },
+    { "ShowlocAddress", 96, 24 },
+    { "FunctionAddSet", 160, 112 },
+    { "FunctionAddUpdate", 48, 24 },
+    { "UpdateFunction", 32, 24 },
+    { "UpdateTransmitCount", 96, 16 },
+    { "CommandLine", 160, 112 },
+};
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+TftMeter::TftMeter() { Reset(); }
+
+/***********************************************************************************************************************
+ */
+void TftMeter::Report(const char* Label)
+{
+    uint8_t Index;
+
+    Serial.print("TFT ");
+    Serial.print(Label);
+    Serial.print(" pixels ");
+    Serial.print(m_Pixels);
+    Serial.print(" spi bytes ");
+    Serial.print(m_SpiBytes);
+    Serial.print(" msec ");
+    Serial.println(millis() - m_Time);
+
+    for (Index = 0; Index < primMax; Index++)
+    {
+        if (m_Calls[Index] != 0)
+        {
+            Serial.print("  ");
+            Serial.print(m_Area[Index].Name);
+            Serial.print(" ");
+            Serial.println(m_Calls[Index]);
+        }
+    }
+
+    Reset();
+}
+
+/***********************************************************************************************************************
+ */
+void TftMeter::ReportTransit(const char* Signature)
+{
+    uint8_t Index        = 0;
+    char Name[32]        = "transit";
+    const char* StartPtr = strstr(Signature, "S = ");
+
+    if (StartPtr != NULL)
+    {
+        StartPtr += 4;
+        while ((StartPtr[Index] != '\0') && (StartPtr[Index] != ']') && (StartPtr[Index] != ';')
+            && (Index < (sizeof(Name) - 1)))
+        {
+            Name[Index] = StartPtr[Index];
+            Index++;
+        }
+        Name[Index] = '\0';
+    }
+
+    Report(Name);
+}
+
+/***********************************************************************************************************************
+ */
+void TftMeter::Reset(void)
+{
+    uint8_t Index;
+
+    for (Index = 0; Index < primMax; Index++)
+    {
+        m_Calls[Index] = 0;
+    }
+
+    m_Pixels   = 0;
+    m_SpiBytes = 0;
+    m_Time     = millis();
+}
+
+/***********************************************************************************************************************
+ */
+void TftMeter::Count(primitive Primitive)
+{
+    uint32_t Pixels = (uint32_t)(m_Area[Primitive].Width) * (uint32_t)(m_Area[Primitive].Height);
+
+    m_Calls[Primitive]++;
+    m_Pixels += Pixels;
+    m_SpiBytes += SPI_BYTES_WINDOW + (Pixels * SPI_BYTES_PIXEL);
+}
@@ -0,0 +1,243 @@
+/**
+ **********************************************************************************************************************
+ * @file  tft_meter.h
+ * @brief TFT wrapper counting the drawing primitives, pixels and SPI bytes of screen updates.
+ ***********************************************************************************************************************
+ */
+#ifndef TFT_METER_H
+#define TFT_METER_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include "WmcTft.h"
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class TftMeter : public WmcTft
+{
+public:
+    /**
+     * Measured drawing primitives.
+     */
+    enum primitive
+    {
+        primInit = 0,
+        primShowVersion,
+        primClear,
+        primUpdateStatus,
+        primShowXpNetAddress,
+        primShowName,
+        primUpdateRunningWheel,
+        primUpdateSelectedAndNumberOfLocs,
+        primUpdateLocInfoSelect,
+        primUpdateLocInfo,
+        primUpdateLocInfoAll,
+        primShowTurnoutScreen,
+        primShowTurnoutAddress,
+        primShowTurnoutDirection,
+        primShowMenu1,
+        primShowMenu2,
+        primShowErase,
+        primShowLocSymbolFw,
+        primShowlocAddress,
+        primFunctionAddSet,
+        primFunctionAddUpdate,
+        primUpdateFunction,
+        primUpdateTransmitCount,
+        primCommandLine,
+        primMax
+    };
+
+    /**
+     * Constructor.
+     */
+    TftMeter();
+
+    /**
+     * Counted drawing functions, forwarded to the TFT.
+     */
+    template <typename... Args> void Init(Args... args)
+    {
+        Count(primInit);
+        WmcTft::Init(args...);
+    }
+
+    template <typename... Args> void ShowVersion(Args... args)
+    {
+        Count(primShowVersion);
+        WmcTft::ShowVersion(args...);
+    }
+
+    template <typename... Args> void Clear(Args... args)
+    {
+        Count(primClear);
+        WmcTft::Clear(args...);
+    }
+
+    template <typename... Args> void UpdateStatus(Args... args)
+    {
+        Count(primUpdateStatus);
+        WmcTft::UpdateStatus(args...);
+    }
+
+    template <typename... Args> void ShowXpNetAddress(Args... args)
+    {
+        Count(primShowXpNetAddress);
+        WmcTft::ShowXpNetAddress(args...);
+    }
+
+    template <typename... Args> void ShowName(Args... args)
+    {
+        Count(primShowName);
+        WmcTft::ShowName(args...);
+    }
+
+    template <typename... Args> void UpdateRunningWheel(Args... args)
+    {
+        Count(primUpdateRunningWheel);
+        WmcTft::UpdateRunningWheel(args...);
+    }
+
+    template <typename... Args> void UpdateSelectedAndNumberOfLocs(Args... args)
+    {
+        Count(primUpdateSelectedAndNumberOfLocs);
+        WmcTft::UpdateSelectedAndNumberOfLocs(args...);
+    }
+
+    template <typename... Args> void UpdateLocInfoSelect(Args... args)
+    {
+        Count(primUpdateLocInfoSelect);
+        WmcTft::UpdateLocInfoSelect(args...);
+    }
+
+    template <typename A, typename B, typename C, typename D>
+    void UpdateLocInfo(A Actual, B Previous, C Assignment, D Name, bool UpdateAll)
+    {
+        Count((UpdateAll == true) ? primUpdateLocInfoAll : primUpdateLocInfo);
+        WmcTft::UpdateLocInfo(Actual, Previous, Assignment, Name, UpdateAll);
+    }
+
+    template <typename... Args> void ShowTurnoutScreen(Args... args)
+    {
+        Count(primShowTurnoutScreen);
+        WmcTft::ShowTurnoutScreen(args...);
+    }
+
+    template <typename... Args> void ShowTurnoutAddress(Args... args)
+    {
+        Count(primShowTurnoutAddress);
+        WmcTft::ShowTurnoutAddress(args...);
+    }
+
+    template <typename... Args> void ShowTurnoutDirection(Args... args)
+    {
+        Count(primShowTurnoutDirection);
+        WmcTft::ShowTurnoutDirection(args...);
+    }
+
+    template <typename... Args> void ShowMenu1(Args... args)
+    {
+        Count(primShowMenu1);
+        WmcTft::ShowMenu1(args...);
+    }
+
+    template <typename... Args> void ShowMenu2(Args... args)
+    {
+        Count(primShowMenu2);
+        WmcTft::ShowMenu2(args...);
+    }
+
+    template <typename... Args> void ShowErase(Args... args)
+    {
+        Count(primShowErase);
+        WmcTft::ShowErase(args...);
+    }
+
+    template <typename... Args> void ShowLocSymbolFw(Args... args)
+    {
+        Count(primShowLocSymbolFw);
+        WmcTft::ShowLocSymbolFw(args...);
+    }
+
+    template <typename... Args> void ShowlocAddress(Args... args)
+    {
+        Count(primShowlocAddress);
+        WmcTft::ShowlocAddress(args...);
+    }
+
+    template <typename... Args> void FunctionAddSet(Args... args)
+    {
+        Count(primFunctionAddSet);
+        WmcTft::FunctionAddSet(args...);
+    }
+
+    template <typename... Args> void FunctionAddUpdate(Args... args)
+    {
+        Count(primFunctionAddUpdate);
+        WmcTft::FunctionAddUpdate(args...);
+    }
+
+    template <typename... Args> void UpdateFunction(Args... args)
+    {
+        Count(primUpdateFunction);
+        WmcTft::UpdateFunction(args...);
+    }
+
+    template <typename... Args> void UpdateTransmitCount(Args... args)
+    {
+        Count(primUpdateTransmitCount);
+        WmcTft::UpdateTransmitCount(args...);
+    }
+
+    template <typename... Args> void CommandLine(Args... args)
+    {
+        Count(primCommandLine);
+        WmcTft::CommandLine(args...);
+    }
+
+    /**
+     * Report the drawing costs since the previous report on the serial port and restart counting.
+     */
+    void Report(const char* Label);
+
+    /**
+     * Report the drawing costs of a state transition. The name of the new state is taken from the signature of the
+     * transit function (__PRETTY_FUNCTION__, "... [with S = stateName]").
+     */
+    void ReportTransit(const char* Signature);
+
+    /**
+     * Restart counting.
+     */
+    void Reset(void);
+
+private:
+    /**
+     * Estimated screen area written by a drawing primitive.
+     */
+    struct primitiveArea
+    {
+        const char* Name;
+        uint8_t Width;
+        uint8_t Height;
+    };
+
+    /**
+     * Count a drawing primitive.
+     */
+    void Count(primitive Primitive);
+
+    static const primitiveArea m_Area[primMax];
+    static const uint8_t SPI_BYTES_WINDOW = 11; /* Column, row address set and memory write command. */
+    static const uint8_t SPI_BYTES_PIXEL  = 2;  /* RGB565. */
+
+    uint16_t m_Calls[primMax];
+    uint32_t m_Pixels;
+    uint32_t m_SpiBytes;
+    uint32_t m_Time;
+};
+
+#endif
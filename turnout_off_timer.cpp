@@ -0,0 +1,181 @@
+/***********************************************************************************************************************
+   @file   turnout_off_timer.cpp
+   @brief  Timer wheel with the pending off commands of activated turnouts.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "turnout_off_timer.h"
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+TurnoutOffTimer::TurnoutOffTimer() { Clear(); }
+
+/***********************************************************************************************************************
+ */
+void TurnoutOffTimer::Clear(void)
+{
+    uint8_t Index;
+
+    for (Index = 0; Index < TIMERS_MAX; Index++)
+    {
+        m_Timers[Index].Address = 0;
+    }
+
+    for (Index = 0; Index < WHEEL_SIZE; Index++)
+    {
+        m_Wheel[Index] = NONE;
+    }
+
+    m_Slot = 0;
+}
+
+/***********************************************************************************************************************
+ */
+uint16_t TurnoutOffTimer::Start(uint16_t Address, uint16_t Ticks)
+{
+    uint8_t Index;
+    uint8_t IndexFirst   = 0;
+    uint16_t Remaining   = 0;
+    uint16_t RemainFirst = 0xFFFF;
+    uint16_t Evicted     = 0;
+
+    if (Ticks == 0)
+    {
+        Ticks = 1;
+    }
+
+    /* Restart of an active turnout. */
+    Index = Find(Address);
+    if (Index != NONE)
+    {
+        Remove(Index);
+    }
+
+    /* Free timer, else the timer which expires first. */
+    Index = Find(0);
+    if (Index == NONE)
+    {
+        for (Index = 0; Index < TIMERS_MAX; Index++)
+        {
+            Remaining = (m_Timers[Index].Rounds * WHEEL_SIZE)
+                + ((m_Timers[Index].Slot + WHEEL_SIZE - m_Slot - 1) % WHEEL_SIZE);
+            if (Remaining < RemainFirst)
+            {
+                RemainFirst = Remaining;
+                IndexFirst  = Index;
+            }
+        }
+
+        Index   = IndexFirst;
+        Evicted = m_Timers[Index].Address;
+        Remove(Index);
+    }
+
+    /* Add to the slot in which it expires. */
+    m_Timers[Index].Address = Address;
+    m_Timers[Index].Slot    = (m_Slot + Ticks) % WHEEL_SIZE;
+    m_Timers[Index].Rounds  = (Ticks - 1) / WHEEL_SIZE;
+    m_Timers[Index].Next    = m_Wheel[m_Timers[Index].Slot];
+
+    m_Wheel[m_Timers[Index].Slot] = Index;
+
+    return (Evicted);
+}
+
+/***********************************************************************************************************************
+ */
+uint8_t TurnoutOffTimer::Tick(uint16_t* AddressPtr)
+{
+    uint8_t Index;
+    uint8_t Next;
+    uint8_t Expired = 0;
+
+    m_Slot = (m_Slot + 1) % WHEEL_SIZE;
+
+    /* Only the timers in the actual slot are checked. */
+    Index = m_Wheel[m_Slot];
+    while (Index != NONE)
+    {
+        Next = m_Timers[Index].Next;
+
+        if (m_Timers[Index].Rounds == 0)
+        {
+            AddressPtr[Expired] = m_Timers[Index].Address;
+            Expired++;
+            Remove(Index);
+        }
+        else
+        {
+            m_Timers[Index].Rounds--;
+        }
+
+        Index = Next;
+    }
+
+    return (Expired);
+}
+
+/***********************************************************************************************************************
+ */
+uint8_t TurnoutOffTimer::Flush(uint16_t* AddressPtr)
+{
+    uint8_t Index;
+    uint8_t Number = 0;
+
+    for (Index = 0; Index < TIMERS_MAX; Index++)
+    {
+        if (m_Timers[Index].Address != 0)
+        {
+            AddressPtr[Number] = m_Timers[Index].Address;
+            Number++;
+        }
+    }
+
+    Clear();
+
+    return (Number);
+}
+
+/***********************************************************************************************************************
+ */
+bool TurnoutOffTimer::Pending(uint16_t Address) { return ((Address != 0) && (Find(Address) != NONE)); }
+
+/***********************************************************************************************************************
+ */
+void TurnoutOffTimer::Remove(uint8_t Index)
+{
+    uint8_t* LinkPtr = &m_Wheel[m_Timers[Index].Slot];
+
+    while (*LinkPtr != Index)
+    {
+        LinkPtr = &m_Timers[*LinkPtr].Next;
+    }
+
+    *LinkPtr                = m_Timers[Index].Next;
+    m_Timers[Index].Address = 0;
+}
+
+/***********************************************************************************************************************
+ */
+uint8_t TurnoutOffTimer::Find(uint16_t Address)
+{
+    uint8_t Index;
+    uint8_t Result = NONE;
+
+    for (Index = 0; Index < TIMERS_MAX; Index++)
+    {
+        if (m_Timers[Index].Address == Address)
+        {
+            Result = Index;
+            break;
+        }
+    }
+
+    return (Result);
+}
@@ -0,0 +1,79 @@
+/**
+ **********************************************************************************************************************
+ * @file  turnout_off_timer.h
+ * @brief Timer wheel with the pending off commands of activated turnouts.
+ ***********************************************************************************************************************
+ */
+#ifndef TURNOUT_OFF_TIMER_H
+#define TURNOUT_OFF_TIMER_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class TurnoutOffTimer
+{
+public:
+    static const uint8_t TIMERS_MAX = 16;
+
+    /**
+     * Constructor.
+     */
+    TurnoutOffTimer();
+
+    /**
+     * Remove all pending timers.
+     */
+    void Clear(void);
+
+    /**
+     * Start (or restart) the timer of a turnout, expires after Ticks calls of Tick(). If all timers are in use the
+     * timer which expires first is removed and its address returned so the off command can be sent immediately,
+     * otherwise 0 is returned.
+     */
+    uint16_t Start(uint16_t Address, uint16_t Ticks);
+
+    /**
+     * Advance the wheel one tick. The addresses of expired timers are stored in AddressPtr, returns the number of
+     * expired timers.
+     */
+    uint8_t Tick(uint16_t* AddressPtr);
+
+    /**
+     * Get the addresses of all pending timers and remove them, returns the number of timers.
+     */
+    uint8_t Flush(uint16_t* AddressPtr);
+
+    /**
+     * Check if a timer of a turnout is pending.
+     */
+    bool Pending(uint16_t Address);
+
+private:
+    static const uint8_t WHEEL_SIZE = 8;
+    static const uint8_t NONE       = 0xFF;
+
+    /**
+     * Timer, address 0 is a free timer.
+     */
+    struct timerEntry
+    {
+        uint16_t Address;
+        uint8_t Slot;
+        uint8_t Rounds;
+        uint8_t Next;
+    };
+
+    void Remove(uint8_t Index);
+    uint8_t Find(uint16_t Address);
+
+    timerEntry m_Timers[TIMERS_MAX];
+    uint8_t m_Wheel[WHEEL_SIZE];
+    uint8_t m_Slot;
+};
+
+#endif
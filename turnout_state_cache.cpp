@@ -0,0 +1,120 @@
+/***********************************************************************************************************************
+   @file   turnout_state_cache.cpp
+   @brief  Cache with the last known position of recently used turnouts.
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+   I N C L U D E S
+ **********************************************************************************************************************/
+#include "turnout_state_cache.h"
+
+/***********************************************************************************************************************
+  F U N C T I O N S
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ */
+TurnoutStateCache::TurnoutStateCache() { Clear(); }
+
+/***********************************************************************************************************************
+ */
+void TurnoutStateCache::Clear(void)
+{
+    uint8_t Index;
+
+    for (Index = 0; Index < CACHE_SIZE; Index++)
+    {
+        m_Entries[Index].Address = 0;
+        m_Entries[Index].Age     = 0;
+    }
+}
+
+/***********************************************************************************************************************
+ */
+void TurnoutStateCache::Store(uint16_t Address, position Position)
+{
+    uint8_t Index;
+    uint8_t IndexStore = 0;
+
+    if (Address != 0)
+    {
+        IndexStore = Find(Address);
+
+        if (IndexStore == CACHE_SIZE)
+        {
+            /* Free entry or else the least recently used one. */
+            IndexStore = 0;
+            for (Index = 0; Index < CACHE_SIZE; Index++)
+            {
+                if (m_Entries[Index].Address == 0)
+                {
+                    IndexStore = Index;
+                    break;
+                }
+                else if (m_Entries[Index].Age > m_Entries[IndexStore].Age)
+                {
+                    IndexStore = Index;
+                }
+            }
+
+            /* New entry, all other entries get older. */
+            m_Entries[IndexStore].Age = CACHE_SIZE;
+        }
+
+        m_Entries[IndexStore].Address  = Address;
+        m_Entries[IndexStore].Position = static_cast<uint8_t>(Position);
+        Touch(IndexStore);
+    }
+}
+
+/***********************************************************************************************************************
+ */
+TurnoutStateCache::position TurnoutStateCache::Get(uint16_t Address)
+{
+    uint8_t Index;
+    position Result = unknown;
+
+    Index = Find(Address);
+    if ((Address != 0) && (Index < CACHE_SIZE))
+    {
+        Result = static_cast<position>(m_Entries[Index].Position);
+        Touch(Index);
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ */
+uint8_t TurnoutStateCache::Find(uint16_t Address)
+{
+    uint8_t Index;
+
+    for (Index = 0; Index < CACHE_SIZE; Index++)
+    {
+        if (m_Entries[Index].Address == Address)
+        {
+            break;
+        }
+    }
+
+    return (Index);
+}
+
+/***********************************************************************************************************************
+ */
+void TurnoutStateCache::Touch(uint8_t Index)
+{
+    uint8_t Entry;
+
+    /* Entries used more recently than this one get older, the age stays below CACHE_SIZE. */
+    for (Entry = 0; Entry < CACHE_SIZE; Entry++)
+    {
+        if ((m_Entries[Entry].Address != 0) && (m_Entries[Entry].Age < m_Entries[Index].Age))
+        {
+            m_Entries[Entry].Age++;
+        }
+    }
+
+    m_Entries[Index].Age = 0;
+}
@@ -0,0 +1,71 @@
+/**
+ **********************************************************************************************************************
+ * @file  turnout_state_cache.h
+ * @brief Cache with the last known position of recently used turnouts.
+ ***********************************************************************************************************************
+ */
+#ifndef TURNOUT_STATE_CACHE_H
+#define TURNOUT_STATE_CACHE_H
+
+/***********************************************************************************************************************
+ * I N C L U D E S
+ **********************************************************************************************************************/
+#include <Arduino.h>
+
+/***********************************************************************************************************************
+ * C L A S S E S
+ **********************************************************************************************************************/
+class TurnoutStateCache
+{
+public:
+    /**
+     * Turnout position.
+     */
+    enum position
+    {
+        unknown = 0,
+        straight,
+        turned,
+        asked, /* Position requested, not known by the central either. */
+    };
+
+    /**
+     * Constructor.
+     */
+    TurnoutStateCache();
+
+    /**
+     * Remove all turnouts.
+     */
+    void Clear(void);
+
+    /**
+     * Store the position of a turnout. If the turnout is not present the least recently used entry is replaced.
+     */
+    void Store(uint16_t Address, position Position);
+
+    /**
+     * Get the position of a turnout, unknown when not present.
+     */
+    position Get(uint16_t Address);
+
+private:
+    /**
+     * Cache entry, address 0 is a free entry.
+     */
+    struct cacheEntry
+    {
+        uint16_t Address;
+        uint8_t Position;
+        uint8_t Age;
+    };
+
+    static const uint8_t CACHE_SIZE = 64;
+
+    uint8_t Find(uint16_t Address);
+    void Touch(uint8_t Index);
+
+    cacheEntry m_Entries[CACHE_SIZE];
+};
+
+#endif
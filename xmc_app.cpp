@@ -7,7 +7,10 @@
    I N C L U D E S
  **********************************************************************************************************************/
 #include "xmc_app.h"
+#include "app_cfg.h"
+#include "eep_cfg.h"
 #include "fsmlist.hpp"
+#include "loc_data_filter.h"
 #include "tinyfsm.hpp"
 #include "version.h"
 #include "wmc_cv.h"
@@ -27,9 +30,18 @@
  **********************************************************************************************************************/
 
 /* Init variables. */
+#if APP_CFG_TFT_METER == 1
+TftMeter xmcApp::m_xmcTft;
+#else
 WmcTft xmcApp::m_xmcTft;
+#endif
 LocLib xmcApp::m_LocLib;
 LocStorage xmcApp::m_LocStorage;
+LocStateCache xmcApp::m_LocStateCache;
+EepI2c xmcApp::m_EepI2c;
+SettingsBlock xmcApp::m_Settings;
+xmcApp::resumeSnapshot xmcApp::m_Snapshot;
+uint16_t xmcApp::m_LocPrefetchAddress[2];
 XpressNetClass xmcApp::m_XpNet;
 locData xmcApp::m_LocDataReceived;
 WmcCli xmcApp::m_WmcCommandLine;
@@ -37,20 +49,51 @@ WmcTft::locoInfo xmcApp::locInfoActual;
 WmcTft::locoInfo xmcApp::locInfoPrevious;
 locData xmcApp::m_LocDataRecievedPrevious;
 uint8_t xmcApp::m_locFunctionAssignment[5];
-uint16_t xmcApp::m_locDbData[200];
-char xmcApp::m_locDbDataName[200][11];
+xmcApp::locDbRecord xmcApp::m_locDbData[LOC_DATABASE_MAX];
 uint16_t xmcApp::m_locDbDataCnt;
+uint8_t xmcApp::m_locDbDataNumbers[(LOC_DATABASE_MAX / 8) + 1];
+uint16_t xmcApp::m_locDbDataChanged;
 uint16_t xmcApp::m_locDbDataTransmitCnt;
 uint32_t xmcApp::m_locDbDataTransmitDelay;
+uint32_t xmcApp::m_locDbDataTransmitInterval;
+bool xmcApp::m_locDbDataTransmitRepeated;
+uint32_t xmcApp::m_locDbDataImportTime;
+uint32_t xmcApp::m_ProgressUpdateTime;
+uint32_t xmcApp::m_BootTime[bootPhaseMax];
+TurnoutOffTimer xmcApp::m_TurnoutOffTimer;
+RouteTable xmcApp::m_Routes;
+RouteTable::route xmcApp::m_Route;
+CvBatch xmcApp::m_CvBatch;
+CvBatch xmcApp::m_CvRestore;
+CvBackup xmcApp::m_CvBackup;
+PomQueue xmcApp::m_PomQueue;
+CvCache xmcApp::m_CvCache;
 xmcApp::powerStatus xmcApp::m_PowerStatus           = off;
 bool xmcApp::m_LocSelection                         = false;
 bool xmcApp::m_PushButtonReleased                   = false;
 uint8_t xmcApp::m_XpNetAddress                      = 0;
 uint8_t xmcApp::m_ConnectCount                      = 0;
+uint8_t xmcApp::m_BootPhasesDone                    = 0;
+xmcApp::appScreen xmcApp::m_Screen                  = screenLoc;
+bool xmcApp::m_ResumeTurnoutControl                 = false;
 uint8_t xmcApp::m_SkipRequestCnt                    = 0;
+uint8_t xmcApp::m_PowerPollSkipCnt                  = 0;
 uint16_t xmcApp::m_TurnOutAddress                   = 1;
 xmcApp::turnoutDirection xmcApp::m_TurnOutDirection = ForwardOff;
-uint32_t xmcApp::m_TurnoutOffDelay                  = 0;
+uint8_t xmcApp::m_RouteIndex                        = 0;
+uint8_t xmcApp::m_RouteStep                         = 0;
+uint16_t xmcApp::m_RouteActive                      = 0;
+bool xmcApp::m_RouteRunning                         = false;
+bool xmcApp::m_RouteLearn                           = false;
+uint32_t xmcApp::m_RouteStartTime                   = 0;
+bool xmcApp::m_TurnoutInfoRequest                   = false;
+xmcApp::cvBatchMode xmcApp::m_CvBatchMode           = cvBatchModeRead;
+uint32_t xmcApp::m_CvBatchTime                      = 0;
+uint16_t xmcApp::m_CvCacheRequest                   = 0;
+uint16_t xmcApp::m_CvCacheServed                    = 0;
+uint8_t xmcApp::m_CvCacheValue                      = 0;
+bool xmcApp::m_CvCacheAnswer                        = false;
+bool xmcApp::m_CvCacheVerify                        = false;
 bool xmcApp::m_CvPomProgrammingFromPowerOn          = false;
 bool xmcApp::m_CvPomProgramming                     = false;
 bool xmcApp::m_EmergencyStopEnabled                 = false;
@@ -61,6 +104,20 @@ uint16_t xmcApp::m_locAddressDelete                 = 1;
 uint8_t xmcApp::m_locFunctionAdd                    = 0;
 uint8_t xmcApp::m_locFunctionChange                 = 0;
 bool xmcApp::m_PulseSwitchInvert                    = false;
+uint8_t xmcApp::m_LocPrefetchCnt                    = 0;
+uint8_t xmcApp::m_LocPrefetchIndex                  = 0;
+uint32_t xmcApp::m_LocPrefetchHit                   = 0;
+uint32_t xmcApp::m_LocPrefetchMiss                  = 0;
+
+/* Filter for unchanged loc data, used in the XpNet callback. */
+static LocDataFilter locDataFilter;
+static TurnoutStateCache turnoutStateCache;
+static BusRtt busRtt;
+static BusMeter busMeter;
+
+/* Poll intervals, loc info 1.5 up to 12 sec and power status 100 msec up to 1.6 sec, slowed down above 100 msec. */
+static PollRate locPollRate(2, 23, 100);
+static PollRate powerPollRate(0, 15, 100);
 
 /* Conversion table for 28 steps DCC speed to normal speed. */
 const uint8_t SpeedStep28TableFromDcc[32] = { 0, 0, 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 0, 0, 2, 4, 6, 8,
@@ -72,15 +129,16 @@ const uint8_t SpeedStep28TableFromDcc[32] = { 0, 0, 1, 3, 5, 7, 9, 11, 13, 15, 1
 
 class stateInit;
 class stateCheckXpNetAddress;
-class stateInitXpNet;
 class stateGetPowerStatus;
 class stateGetLocData;
 class statePowerOff;
+class stateLocDatabaseRemove;
 class statePowerOn;
 class statePowerEmergencyStop;
 class stateProgrammingMode;
 class stateTurnoutControl;
 class stateTurnoutControlPowerOff;
+class stateRouteControl;
 class stateMainMenu1;
 class stateMainMenu2;
 class stateMenuLocAdd;
@@ -90,48 +148,90 @@ class stateMenuLocDelete;
 class stateMenuTransmitLocDatabase;
 class stateCommandLineInterfaceActive;
 class stateCvProgramming;
+class stateCvBatch;
 
 /***********************************************************************************************************************
- * Init the application and show start screen 3 seconds.
+ * Init the application and show start screen.
  */
 class stateInit : public xmcApp
 {
     /**
-     * Init modules
+     * Init modules. With a valid XpNet address XpNet is started before the loc library is loaded, so the XpNet
+     * module and central already exchange the power status while the loc library is read from the EEPROM.
      */
     void entry() override
     {
+        bootTimeStamp(bootStart);
         m_xmcTft.Init();
         m_xmcTft.ShowVersion(SW_MAJOR, SW_MINOR, SW_PATCH);
+        bootTimeStamp(bootTftReady);
 
         m_LocStorage.Init();
+        m_EepI2c.Init();
+        m_Settings.Load(m_EepI2c, m_LocStorage);
+        m_Routes.Init(m_EepI2c);
+        m_CvBackup.Init(m_EepI2c);
+        m_XpNetAddress = m_Settings.XpNetAddressGet();
+        if (m_XpNetAddress <= 31)
+        {
+            XpNetStart();
+        }
+
         m_LocLib.Init(m_LocStorage);
+        bootTimeStamp(bootLocLibLoaded);
         m_WmcCommandLine.Init(m_LocLib, m_LocStorage);
         m_ConnectCount = 0;
+
+        /* Show the state before power down right away, it is verified with the central in the background. */
+        if ((m_XpNetAddress <= 31) && (snapshotRestore() == true))
+        {
+            m_xmcTft.Clear();
+            switch (m_PowerStatus)
+            {
+            case powerStatus::off: m_xmcTft.UpdateStatus("POWER OFF", false, WmcTft::color_red); break;
+            case powerStatus::on: m_xmcTft.UpdateStatus("POWER ON ", false, WmcTft::color_green); break;
+            case powerStatus::emergency: m_xmcTft.UpdateStatus("POWER ON ", true, WmcTft::color_yellow); break;
+            case powerStatus::progMode: m_xmcTft.UpdateStatus("PROG MODE", true, WmcTft::color_yellow); break;
+            }
+
+            /* Speed, direction and functions are shown when the first loc info is received. */
+            m_LocSelection = true;
+            m_xmcTft.UpdateLocInfoSelect(m_LocLib.GetActualLocAddress(), m_LocLib.GetLocName());
+            m_xmcTft.UpdateSelectedAndNumberOfLocs(m_LocLib.GetActualSelectedLocIndex(), m_LocLib.GetNumberOfLocs());
+        }
+    }
+
+    /**
+     * If invalid XpNet address go to setting valid address.
+     */
+    void react(updateEvent100msec const&) override
+    {
+        if (m_XpNetAddress > 31)
+        {
+            transit<stateCheckXpNetAddress>();
+        }
     }
 
     /**
-     * 3 Seconds timeout
+     * No response of the central yet, wait for it showing the connecting screen.
      */
     void react(updateEvent500msec const&) override
     {
-        /* Some delay so app name is displayed after power on. */
-        m_ConnectCount++;
-        if (m_ConnectCount >= 2)
+        if (m_XpNetAddress <= 31)
         {
-            m_XpNetAddress = m_LocStorage.XpNetAddressGet();
+            transit<stateGetPowerStatus>();
+        }
+    }
 
-            if (m_XpNetAddress > 31)
-            {
-                /* If invalid XpNet address go to setting valid address. */
-                transit<stateCheckXpNetAddress>();
-            }
-            else
-            {
-                /* Valid XpNet address, start.... */
-                m_ConnectCount = 0;
-                transit<stateInitXpNet>();
-            }
+    /**
+     * First response of the central, XpNet is ready. Handle the response in the power status state.
+     */
+    void react(XpNetEvent const& e) override
+    {
+        if ((m_XpNetAddress <= 31) && (e.dataType != locdata))
+        {
+            transit<stateGetPowerStatus>();
+            dispatch(e);
         }
     }
 };
@@ -192,8 +292,10 @@ class stateCheckXpNetAddress : public xmcApp
             break;
         case pushedNormal:
         case pushedlong:
-            /* Store selected address and reset to activate new address. */
-            m_LocStorage.XpNetAddressSet(m_XpNetAddress);
+            /* Store selected address and reset to activate it, the XpNet module is only started once. */
+            m_Settings.XpNetAddressSet(m_XpNetAddress);
+            m_Settings.Commit();
+            m_EepI2c.Flush();
             m_xmcTft.Clear();
             nvic_sys_reset();
             break;
@@ -212,27 +314,6 @@ class stateCheckXpNetAddress : public xmcApp
     }
 };
 
-/***********************************************************************************************************************
- * Init the Xpressnet module.
- */
-class stateInitXpNet : public xmcApp
-{
-    /**
-     * Init xpressnet module.
-     */
-    void entry() override
-    {
-        m_XpNet.start(m_XpNetAddress, PB0);
-        m_PulseSwitchInvert    = m_LocStorage.PulseSwitchInvertGet();
-        m_EmergencyStopEnabled = m_LocStorage.EmergencyOptionGet();
-    }
-
-    /**
-     * Next state.
-     */
-    void react(updateEvent500msec const&) override { transit<stateGetPowerStatus>(); }
-};
-
 /***********************************************************************************************************************
  * Get the power status of the central unit.
  */
@@ -250,9 +331,17 @@ class stateGetPowerStatus : public xmcApp
     {
         if (m_XpNet.getPower() != 255)
         {
-            m_XpNet.commandStationStatusRequest();
+            if (m_PowerPollSkipCnt > 0)
+            {
+                m_PowerPollSkipCnt--;
+            }
+            else
+            {
+                m_PowerPollSkipCnt = powerPollRate.SkipGet();
+                powerStatusRequest();
+            }
         }
-        m_WmcCommandLine.Update();
+        commandLineUpdate();
     }
 
     /**
@@ -272,6 +361,11 @@ class stateGetPowerStatus : public xmcApp
 
     void react(XpNetEvent const& e) override
     {
+        if (e.dataType != locdata)
+        {
+            bootTimeStamp(bootPowerStatus);
+        }
+
         switch (e.dataType)
         {
         case none:
@@ -294,7 +388,8 @@ class stateGetPowerStatus : public xmcApp
             break;
         case cvResponse:
         case locDataBase:
-        case locDatabaseTransmit: break;
+        case locDatabaseTransmit:
+        case turnoutInfo: break;
         }
     }
 };
@@ -308,7 +403,8 @@ class stateGetLocData : public xmcApp
      */
     void entry() override
     {
-        m_XpNet.getLocoInfo((uint8_t)(m_LocLib.GetActualLocAddress() >> 8), (uint8_t)(m_LocLib.GetActualLocAddress()));
+        locDataFilter.Force();
+        locInfoRequest(m_LocLib.GetActualLocAddress());
     }
 
     /**
@@ -316,7 +412,8 @@ class stateGetLocData : public xmcApp
      */
     void react(updateEvent500msec const&) override
     {
-        m_XpNet.getLocoInfo((uint8_t)(m_LocLib.GetActualLocAddress() >> 8), (uint8_t)(m_LocLib.GetActualLocAddress()));
+        locDataFilter.Force();
+        locInfoRequest(m_LocLib.GetActualLocAddress());
     }
 
     /**
@@ -324,7 +421,8 @@ class stateGetLocData : public xmcApp
      */
     void react(XpNetEvent const& e) override
     {
-        locData* LocDataPtr = NULL;
+        locData* LocDataPtr       = NULL;
+        bool ResumeTurnoutControl = false;
 
         switch (e.dataType)
         {
@@ -339,21 +437,38 @@ class stateGetLocData : public xmcApp
         case locdata:
             LocDataPtr = (locData*)(e.Data);
             memcpy(&m_LocDataReceived, LocDataPtr, sizeof(locData));
+            m_LocStateCache.Store(LocDataPtr, millis());
 
             m_xmcTft.Clear();
             updateLocInfoOnScreen(true);
+            bootTimeStamp(bootLocData);
+
+            /* Continue with turnout control if it was active before power down. */
+            ResumeTurnoutControl   = m_ResumeTurnoutControl;
+            m_ResumeTurnoutControl = false;
 
             switch (m_PowerStatus)
             {
             case powerStatus::off: transit<statePowerOff>(); break;
-            case powerStatus::on: transit<statePowerOn>(); break;
+            case powerStatus::on:
+                if (ResumeTurnoutControl == true)
+                {
+                    m_xmcTft.Clear();
+                    transit<stateTurnoutControl>();
+                }
+                else
+                {
+                    transit<statePowerOn>();
+                }
+                break;
             case powerStatus::emergency: transit<statePowerEmergencyStop>(); break;
             case powerStatus::progMode: transit<stateProgrammingMode>(); break;
             }
             break;
         case cvResponse:
         case locDataBase:
-        case locDatabaseTransmit: break;
+        case locDatabaseTransmit:
+        case turnoutInfo: break;
         }
     }
 };
@@ -368,6 +483,7 @@ class statePowerOff : public xmcApp
     void entry() override
     {
         m_PowerStatus        = powerStatus::off;
+        m_Screen             = screenLoc;
         m_locDbDataCnt       = 0;
         m_LocSelection       = false;
         m_PushButtonReleased = false;
@@ -379,6 +495,16 @@ class statePowerOff : public xmcApp
         m_LocDataReceived.Speed = 0;
         updateLocInfoOnScreen(false);
         preparAndTransmitLocoDriveCommand(m_LocLib.SpeedGet());
+        snapshotStore();
+    }
+
+    /**
+     * Prefetch loc info of neighbouring locs while selecting a loc.
+     */
+    void react(updateEvent100msec const&) override
+    {
+        locPrefetchUpdate();
+        commandLineUpdate();
     }
 
     /**
@@ -393,11 +519,11 @@ class statePowerOff : public xmcApp
         }
         else
         {
-            m_SkipRequestCnt = 2;
+            /* Poll interval depends on the bus load, transmitted commands are never delayed. */
+            m_SkipRequestCnt = locPollRate.SkipGet();
             if (m_LocSelection == false)
             {
-                m_XpNet.getLocoInfo(
-                    (uint8_t)(m_LocLib.GetActualLocAddress() >> 8), (uint8_t)(m_LocLib.GetActualLocAddress()));
+                locInfoRequest(m_LocLib.GetActualLocAddress());
             }
         }
     }
@@ -409,6 +535,7 @@ class statePowerOff : public xmcApp
     {
         locData* LocDataPtr             = NULL;
         locDatabaseData* locDatabasePtr = NULL;
+        uint16_t locChanged             = 0;
 
         switch (e.dataType)
         {
@@ -418,13 +545,17 @@ class statePowerOff : public xmcApp
 
         case powerStop: break;
         case locdata:
-            // Only update when not selecting a loc or when button released after selecting.
-            if ((m_LocSelection == false) || (m_PushButtonReleased = true))
-            {
-                LocDataPtr = (locData*)(e.Data);
+            LocDataPtr = (locData*)(e.Data);
 
-                /* Roco Multimaus keeps transmitting set speed... Force zero speed. */
-                LocDataPtr->Speed = 0;
+            /* Roco Multimaus keeps transmitting set speed... Force zero speed. */
+            LocDataPtr->Speed = 0;
+            m_LocStateCache.Store(LocDataPtr, millis());
+
+            // Only update when not selecting a loc or when button released after selecting. Data of other locs is
+            // prefetched data which is only stored.
+            if ((LocDataPtr->Address == m_LocLib.GetActualLocAddress())
+                && ((m_LocSelection == false) || (m_PushButtonReleased == true)))
+            {
                 memcpy(&m_LocDataReceived, LocDataPtr, sizeof(locData));
                 updateLocInfoOnScreen(m_PushButtonReleased);
                 m_PushButtonReleased = false;
@@ -441,45 +572,70 @@ class statePowerOff : public xmcApp
             /* First database entry received? Reset counter. */
             if (locDatabasePtr->Number == 0)
             {
-                m_locDbDataCnt = 0;
+                m_locDbDataCnt        = 0;
+                m_locDbDataImportTime = millis();
+                memset(m_locDbDataNumbers, 0, sizeof(m_locDbDataNumbers));
                 m_xmcTft.UpdateStatus("RECEIVING", false, WmcTft::color_white);
+            }
 
-                // Copy initial loc data.
-                m_locDbData[m_locDbDataCnt] = locDatabasePtr->Address;
-                memset(&m_locDbDataName[m_locDbDataCnt][0], '\0', 11);
-                memcpy(&m_locDbDataName[m_locDbDataCnt][0], locDatabasePtr->NameStr, 11 - 1);
+            /* Remember which entries of the sender were received, repeated entries are counted only once. */
+            m_locDbDataNumbers[locDatabasePtr->Number >> 3] |= (1 << (locDatabasePtr->Number & 7));
 
-                /* Update status row indicating something is happening. */
-                m_xmcTft.UpdateSelectedAndNumberOfLocs(1, m_locDbDataCnt + 1);
-            }
-            else
+            /* XpressNet sends loc database data twice, only store one of both identical messages.*/
+            if ((m_locDbDataCnt == 0)
+                || (m_locDbData[m_locDbDataCnt - 1].Address != locDatabasePtr->Address))
             {
-                /* XpressNet sends loc database data twice, only store one of both identical messages.*/
-                if (m_locDbData[m_locDbDataCnt] != locDatabasePtr->Address)
+                /* Add received loc address and name, a shorter name is padded with zeros. */
+                if (m_locDbDataCnt < LOC_DATABASE_MAX)
                 {
-                    /* Add received loc address */
+                    m_locDbData[m_locDbDataCnt].Address = locDatabasePtr->Address;
+                    strncpy(m_locDbData[m_locDbDataCnt].Name, locDatabasePtr->NameStr, LOC_DB_NAME_LENGTH);
                     m_locDbDataCnt++;
-                    m_locDbData[m_locDbDataCnt] = locDatabasePtr->Address;
-                    memset(&m_locDbDataName[m_locDbDataCnt][0], '\0', 11);
-                    memcpy(&m_locDbDataName[m_locDbDataCnt][0], locDatabasePtr->NameStr, 11 - 1);
-
-                    /* Update status row indicating something is happening. */
-                    m_xmcTft.UpdateSelectedAndNumberOfLocs(1, m_locDbDataCnt + 1);
                 }
+
+                /* Update status row indicating something is happening. */
+                UpdateProgress(1, m_locDbDataCnt, (locDatabasePtr->Number == 0));
             }
 
             /* All received? Store and sort data. */
             if ((locDatabasePtr->Number + 1) == locDatabasePtr->Total)
             {
-                StoreAndSortLocDatabaseData();
-
-                /* Reset so new loc data can be used. */
-                nvic_sys_reset();
+                UpdateProgress(1, m_locDbDataCnt, true);
+                locChanged = StoreAndSortLocDatabaseData();
+
+#if APP_CFG_DIAG == 1
+                Serial.print("Loc database import msec ");
+                Serial.print(millis() - m_locDbDataImportTime);
+                Serial.print(" changed ");
+                Serial.println(locChanged);
+                Serial.flush();
+#endif
+
+                if ((locDatabaseComplete(locDatabasePtr->Total) == true) && (RemoveMissingLocDatabaseData(false) > 0))
+                {
+                    /* Locs not present at the sender are only removed after confirmation. */
+                    m_locDbDataChanged = locChanged;
+                    transit<stateLocDatabaseRemove>();
+                }
+                else if (locChanged > 0)
+                {
+                    /* Reset so new loc data can be used. */
+                    m_EepI2c.Flush();
+                    m_xmcTft.Clear();
+                    nvic_sys_reset();
+                }
+                else
+                {
+                    /* Received library equals the own library, nothing changed. */
+                    m_xmcTft.UpdateStatus("POWER OFF", false, WmcTft::color_red);
+                    UpdateProgress(m_LocLib.GetActualSelectedLocIndex(), m_LocLib.GetNumberOfLocs(), true);
+                }
             }
         }
         break;
         case cvResponse:
-        case locDatabaseTransmit: break;
+        case locDatabaseTransmit:
+        case turnoutInfo: break;
         }
     }
 
@@ -494,23 +650,31 @@ class statePowerOff : public xmcApp
             /* Select next or previous loc. */
             if (CheckPulseSwitchRevert(e.Delta) != 0)
             {
+                m_EepI2c.Flush();
                 m_LocLib.GetNextLoc(CheckPulseSwitchRevert(CheckPulseSwitchRevert(e.Delta)));
                 m_xmcTft.UpdateSelectedAndNumberOfLocs(
                     m_LocLib.GetActualSelectedLocIndex(), m_LocLib.GetNumberOfLocs());
-                m_xmcTft.UpdateLocInfoSelect(m_LocLib.GetActualLocAddress(), m_LocLib.GetLocName());
                 m_LocSelection = true;
+
+                /* Show complete loc info when known, else only address and name until loc info is received. */
+                if (updateLocInfoFromCache() == false)
+                {
+                    m_xmcTft.UpdateLocInfoSelect(m_LocLib.GetActualLocAddress(), m_LocLib.GetLocName());
+                }
+                locPrefetchPrepare();
             }
             break;
         case pushedShort:
             /* Power on request. */
-            m_XpNet.setPower(csNormal);
+            powerSet(csNormal);
             break;
         case pushedlong: transit<stateMainMenu1>(); break;
         case released:
+            locPrefetchResult();
+            locDataFilter.Force();
             m_SkipRequestCnt     = 2;
             m_PushButtonReleased = true;
-            m_XpNet.getLocoInfo(
-                (uint8_t)(m_LocLib.GetActualLocAddress() >> 8), (uint8_t)(m_LocLib.GetActualLocAddress()));
+            locInfoRequest(m_LocLib.GetActualLocAddress());
             break;
 
         default: break;
@@ -524,7 +688,7 @@ class statePowerOff : public xmcApp
     {
         switch (e.Button)
         {
-        case button_power: m_XpNet.setPower(csNormal); break;
+        case button_power: powerSet(csNormal); break;
         case button_0:
         case button_1:
         case button_2:
@@ -536,6 +700,56 @@ class statePowerOff : public xmcApp
     };
 };
 
+/***********************************************************************************************************************
+ * Ask whether locs which are not present in the complete received loc library of the sender must be removed.
+ */
+class stateLocDatabaseRemove : public xmcApp
+{
+    /**
+     * Show the number of locs which would be removed.
+     */
+    void entry() override
+    {
+        char Text[20];
+
+        snprintf(Text, sizeof(Text), "REMOVE %u LOCS", RemoveMissingLocDatabaseData(false));
+        m_xmcTft.UpdateStatus(Text, false, WmcTft::color_yellow);
+    }
+
+    /**
+     * Push to remove the locs, turn to keep them.
+     */
+    void react(pulseSwitchEvent const& e) override
+    {
+        switch (e.Status)
+        {
+        case pushedNormal:
+            m_xmcTft.UpdateStatus("REMOVING ", false, WmcTft::color_white);
+            RemoveMissingLocDatabaseData(true);
+
+            /* Reset so new loc data can be used. */
+            m_EepI2c.Flush();
+            m_xmcTft.Clear();
+            nvic_sys_reset();
+            break;
+        case turn:
+            if (m_locDbDataChanged > 0)
+            {
+                /* Reset so new loc data can be used. */
+                m_EepI2c.Flush();
+                m_xmcTft.Clear();
+                nvic_sys_reset();
+            }
+            else
+            {
+                transit<statePowerOff>();
+            }
+            break;
+        default: break;
+        }
+    }
+};
+
 /***********************************************************************************************************************
  * Power off state.
  */
@@ -547,10 +761,21 @@ class statePowerOn : public xmcApp
     {
         m_LocSelection       = false;
         m_PowerStatus        = powerStatus::on;
+        m_Screen             = screenLoc;
         m_SkipRequestCnt     = 0;
         m_PushButtonReleased = false;
         m_xmcTft.UpdateStatus("POWER ON ", false, WmcTft::color_green);
         m_xmcTft.UpdateSelectedAndNumberOfLocs(m_LocLib.GetActualSelectedLocIndex(), m_LocLib.GetNumberOfLocs());
+        snapshotStore();
+    }
+
+    /**
+     * Prefetch loc info of neighbouring locs while selecting a loc.
+     */
+    void react(updateEvent100msec const&) override
+    {
+        locPrefetchUpdate();
+        commandLineUpdate();
     }
 
     /**
@@ -564,11 +789,11 @@ class statePowerOn : public xmcApp
         }
         else
         {
-            m_SkipRequestCnt = 2;
+            /* Poll interval depends on the bus load, transmitted commands are never delayed. */
+            m_SkipRequestCnt = locPollRate.SkipGet();
             if (m_LocSelection == false)
             {
-                m_XpNet.getLocoInfo(
-                    (uint8_t)(m_LocLib.GetActualLocAddress() >> 8), (uint8_t)(m_LocLib.GetActualLocAddress()));
+                locInfoRequest(m_LocLib.GetActualLocAddress());
             }
         }
     }
@@ -586,10 +811,13 @@ class statePowerOn : public xmcApp
         case powerOff: transit<statePowerOff>(); break;
         case powerStop: transit<statePowerEmergencyStop>(); break;
         case locdata:
-            // Only update when not selecting a loc.
-            if ((m_LocSelection == false) || (m_PushButtonReleased == true))
+            LocDataPtr = (locData*)(e.Data);
+            m_LocStateCache.Store(LocDataPtr, millis());
+
+            // Only update when not selecting a loc. Data of other locs is prefetched data which is only stored.
+            if ((LocDataPtr->Address == m_LocLib.GetActualLocAddress())
+                && ((m_LocSelection == false) || (m_PushButtonReleased == true)))
             {
-                LocDataPtr = (locData*)(e.Data);
                 memcpy(&m_LocDataReceived, LocDataPtr, sizeof(locData));
                 updateLocInfoOnScreen(m_PushButtonReleased);
                 m_PushButtonReleased = false;
@@ -601,6 +829,7 @@ class statePowerOn : public xmcApp
             break;
         case locDataBase:
         case locDatabaseTransmit:
+        case turnoutInfo:
         case cvResponse: break;
         }
     }
@@ -626,11 +855,18 @@ class statePowerOn : public xmcApp
             /* Select next or previous loc. */
             if (CheckPulseSwitchRevert(e.Delta) != 0)
             {
+                m_EepI2c.Flush();
                 m_LocLib.GetNextLoc(CheckPulseSwitchRevert(CheckPulseSwitchRevert(e.Delta)));
                 m_xmcTft.UpdateSelectedAndNumberOfLocs(
                     m_LocLib.GetActualSelectedLocIndex(), m_LocLib.GetNumberOfLocs());
-                m_xmcTft.UpdateLocInfoSelect(m_LocLib.GetActualLocAddress(), m_LocLib.GetLocName());
                 m_LocSelection = true;
+
+                /* Show complete loc info when known, else only address and name until loc info is received. */
+                if (updateLocInfoFromCache() == false)
+                {
+                    m_xmcTft.UpdateLocInfoSelect(m_LocLib.GetActualLocAddress(), m_LocLib.GetLocName());
+                }
+                locPrefetchPrepare();
             }
             break;
         case pushedShort:
@@ -660,10 +896,11 @@ class statePowerOn : public xmcApp
             transit<stateCvProgramming>();
             break;
         case released:
+            locPrefetchResult();
+            locDataFilter.Force();
             m_PushButtonReleased = true;
             m_SkipRequestCnt     = 2;
-            m_XpNet.getLocoInfo(
-                (uint8_t)(m_LocLib.GetActualLocAddress() >> 8), (uint8_t)(m_LocLib.GetActualLocAddress()));
+            locInfoRequest(m_LocLib.GetActualLocAddress());
             break;
         default: break;
         }
@@ -680,11 +917,11 @@ class statePowerOn : public xmcApp
         case button_power:
             if (m_EmergencyStopEnabled == false)
             {
-                m_XpNet.setPower(csTrackVoltageOff);
+                powerSet(csTrackVoltageOff);
             }
             else
             {
-                m_XpNet.setPower(csEmergencyStop);
+                powerSet(csEmergencyStop);
             }
             break;
         case button_0:
@@ -696,6 +933,7 @@ class statePowerOn : public xmcApp
             Function = m_LocLib.FunctionAssignedGet(static_cast<uint8_t>(e.Button));
             m_LocLib.FunctionToggle(Function);
 
+            busMeter.Transmit(BusMeter::categoryFunction, BusMeter::SIZE_LOC_FUNC);
             if (m_LocLib.FunctionStatusGet(Function) == LocLib::functionOn)
             {
                 m_XpNet.setLocoFunc((uint8_t)(m_LocLib.GetActualLocAddress() >> 8),
@@ -729,6 +967,7 @@ class statePowerEmergencyStop : public xmcApp
     void entry() override
     {
         m_PowerStatus = powerStatus::emergency;
+        m_Screen      = screenLoc;
         m_xmcTft.UpdateStatus("POWER ON ", true, WmcTft::color_yellow);
         m_xmcTft.UpdateSelectedAndNumberOfLocs(m_LocLib.GetActualSelectedLocIndex(), m_LocLib.GetNumberOfLocs());
 
@@ -739,6 +978,7 @@ class statePowerEmergencyStop : public xmcApp
 
         /* Transmit zero speed of selected loc... */
         preparAndTransmitLocoDriveCommand(m_LocLib.SpeedGet());
+        snapshotStore();
     };
 
     /**
@@ -756,6 +996,7 @@ class statePowerEmergencyStop : public xmcApp
         case locdata:
             LocDataPtr = (locData*)(e.Data);
             memcpy(&m_LocDataReceived, LocDataPtr, sizeof(locData));
+            m_LocStateCache.Store(LocDataPtr, millis());
             updateLocInfoOnScreen(false);
             break;
         case programmingMode:
@@ -764,6 +1005,7 @@ class statePowerEmergencyStop : public xmcApp
             break;
         case cvResponse:
         case locDatabaseTransmit:
+        case turnoutInfo:
         case locDataBase: break;
         }
     }
@@ -800,7 +1042,7 @@ class statePowerEmergencyStop : public xmcApp
         uint8_t Function = 0;
         switch (e.Button)
         {
-        case button_power: m_XpNet.setPower(csNormal); break;
+        case button_power: powerSet(csNormal); break;
         case button_0:
         case button_1:
         case button_2:
@@ -810,6 +1052,7 @@ class statePowerEmergencyStop : public xmcApp
             Function = m_LocLib.FunctionAssignedGet(static_cast<uint8_t>(e.Button));
             m_LocLib.FunctionToggle(Function);
 
+            busMeter.Transmit(BusMeter::categoryFunction, BusMeter::SIZE_LOC_FUNC);
             if (m_LocLib.FunctionStatusGet(Function) == LocLib::functionOn)
             {
                 m_XpNet.setLocoFunc((uint8_t)(m_LocLib.GetActualLocAddress() >> 8),
@@ -859,7 +1102,8 @@ class stateProgrammingMode : public xmcApp
         case programmingMode:
         case cvResponse:
         case locDataBase:
-        case locDatabaseTransmit: break;
+        case locDatabaseTransmit:
+        case turnoutInfo: break;
         }
     }
 
@@ -870,7 +1114,7 @@ class stateProgrammingMode : public xmcApp
     {
         switch (e.Button)
         {
-        case button_power: m_XpNet.setPower(csTrackVoltageOff); break;
+        case button_power: powerSet(csTrackVoltageOff); break;
         case button_0:
         case button_1:
         case button_2:
@@ -892,26 +1136,38 @@ class stateTurnoutControl : public xmcApp
      */
     void entry() override
     {
-        m_TurnOutDirection = ForwardOff;
+        m_Screen = screenTurnout;
 
-        m_xmcTft.UpdateStatus("TURNOUT", true, WmcTft::color_green);
+        if (m_RouteLearn == true)
+        {
+            m_xmcTft.UpdateStatus("LEARN", true, WmcTft::color_yellow);
+        }
+        else
+        {
+            m_xmcTft.UpdateStatus("TURNOUT", true, WmcTft::color_green);
+        }
         m_xmcTft.ShowTurnoutScreen();
-        m_xmcTft.ShowTurnoutAddress(m_TurnOutAddress);
-        m_xmcTft.ShowTurnoutDirection(static_cast<uint8_t>(m_TurnOutDirection));
+        turnoutShow();
+        snapshotStore();
     };
 
     /**
-     * Handle received data.
+     * Sent off commands of turnouts for which the pulse time expired. Request the position of a turnout not in the
+     * cache when the address did not change for one update.
      */
-    void react(updateEvent500msec const&) override
+    void react(updateEvent100msec const&) override
     {
-        /* When turnout active sent after 500msec off command. */
-        if ((m_TurnOutDirection == Forward) || (m_TurnOutDirection == Turn))
+        turnoutOffUpdate(false);
+
+        if (m_TurnoutInfoRequest == true)
         {
-            m_TurnOutDirection = ForwardOff;
-            m_XpNet.setTrntPos((m_TurnOutAddress - 1) >> 8, (uint8_t)(m_TurnOutAddress - 1), 0x00);
-            m_xmcTft.ShowTurnoutDirection(static_cast<uint8_t>(m_TurnOutDirection));
+            m_TurnoutInfoRequest = false;
+            busMeter.Transmit(BusMeter::categoryPoll, BusMeter::SIZE_TURNOUT);
+            m_XpNet.getTrntInfo((m_TurnOutAddress - 1) >> 8, (uint8_t)(m_TurnOutAddress - 1));
+            turnoutStateCache.Store(m_TurnOutAddress, TurnoutStateCache::asked);
         }
+
+        commandLineUpdate();
     };
 
     /**
@@ -933,6 +1189,14 @@ class stateTurnoutControl : public xmcApp
         case cvResponse:
         case locDataBase:
         case locDatabaseTransmit: break;
+        case turnoutInfo:
+            /* Show position of shown turnout when not activated by us. */
+            if ((((turnoutInfoData*)(e.Data))->Address == m_TurnOutAddress) && (m_TurnOutDirection != Forward)
+                && (m_TurnOutDirection != Turn))
+            {
+                turnoutShow();
+            }
+            break;
         }
     }
 
@@ -944,7 +1208,15 @@ class stateTurnoutControl : public xmcApp
         bool updateScreen = false;
         switch (e.Status)
         {
-        case pushturn: break;
+        case pushturn:
+            /* To route control, a learned route is stored. */
+            if (m_RouteLearn == true)
+            {
+                m_RouteLearn = false;
+                m_Routes.Store(m_RouteIndex, &m_Route);
+            }
+            transit<stateRouteControl>();
+            break;
         case turn:
             if (CheckPulseSwitchRevert(e.Delta) > 0)
             {
@@ -988,10 +1260,10 @@ class stateTurnoutControl : public xmcApp
         default: break;
         }
 
-        /* Update address on display if required. */
+        /* Update address and position on display if required. */
         if (updateScreen == true)
         {
-            m_xmcTft.ShowTurnoutAddress(m_TurnOutAddress);
+            turnoutShow();
         }
     };
 
@@ -1007,20 +1279,18 @@ class stateTurnoutControl : public xmcApp
         /* Handle button requests. */
         switch (e.Button)
         {
-        case button_power: m_XpNet.setPower(csTrackVoltageOff); break;
+        case button_power: powerSet(csTrackVoltageOff); break;
         case button_0: m_TurnOutAddress++; break;
         case button_1: m_TurnOutAddress += 10; break;
         case button_2: m_TurnOutAddress += 100; break;
         case button_3: m_TurnOutAddress += 1000; break;
         case button_4:
             m_TurnOutDirection = Forward;
-            m_TurnoutOffDelay  = millis();
             updateScreen       = false;
             sentTurnOutCommand = true;
             break;
         case button_5:
             m_TurnOutDirection = Turn;
-            m_TurnoutOffDelay  = millis();
             updateScreen       = false;
             sentTurnOutCommand = true;
             break;
@@ -1033,7 +1303,7 @@ class stateTurnoutControl : public xmcApp
             {
                 m_TurnOutAddress = 1;
             }
-            m_xmcTft.ShowTurnoutAddress(m_TurnOutAddress);
+            turnoutShow();
         }
 
         if (sentTurnOutCommand == true)
@@ -1044,21 +1314,33 @@ class stateTurnoutControl : public xmcApp
             {
                 turnoutData |= 1;
             }
+            busMeter.Transmit(BusMeter::categoryAccessory, BusMeter::SIZE_TURNOUT);
             m_XpNet.setTrntPos((m_TurnOutAddress - 1) >> 8, (uint8_t)(m_TurnOutAddress - 1), turnoutData);
             m_xmcTft.ShowTurnoutDirection(static_cast<uint8_t>(m_TurnOutDirection));
+            turnoutStateCache.Store(m_TurnOutAddress,
+                (m_TurnOutDirection == Turn) ? TurnoutStateCache::turned : TurnoutStateCache::straight);
+            m_TurnoutInfoRequest = false;
+
+            /* Each activated turnout gets its own off command, if no timer is free the first one is sent now. */
+            turnoutOff(m_TurnoutOffTimer.Start(m_TurnOutAddress, turnoutPulseTicks()));
+
+            /* Add turnout to the route being learned. */
+            if ((m_RouteLearn == true) && (m_Route.Steps < RouteTable::STEPS_MAX))
+            {
+                m_Route.Step[m_Route.Steps] = RouteTable::StepSet(m_TurnOutAddress, (m_TurnOutDirection == Turn));
+                m_Route.Steps++;
+            }
         }
     };
 
     /**
-     * When exit and turnout active transmit off command.
+     * When exit and turnouts active transmit off commands. A route being learned is only stored when going to route
+     * control.
      */
     void exit() override
     {
-        if ((m_TurnOutDirection == Forward) || (m_TurnOutDirection == Turn))
-        {
-            m_TurnOutDirection = ForwardOff;
-            m_XpNet.setTrntPos((m_TurnOutAddress - 1) >> 8, (uint8_t)(m_TurnOutAddress - 1), m_TurnOutDirection);
-        }
+        turnoutOffUpdate(true);
+        m_RouteLearn = false;
     }
 };
 
@@ -1094,7 +1376,8 @@ class stateTurnoutControlPowerOff : public xmcApp
             break;
         case cvResponse:
         case locDataBase:
-        case locDatabaseTransmit: break;
+        case locDatabaseTransmit:
+        case turnoutInfo: break;
         }
     }
 
@@ -1125,7 +1408,7 @@ class stateTurnoutControlPowerOff : public xmcApp
         /* Handle button requests. */
         switch (e.Button)
         {
-        case button_power: m_XpNet.setPower(csNormal); break;
+        case button_power: powerSet(csNormal); break;
         case button_0:
         case button_1:
         case button_2:
@@ -1138,14 +1421,54 @@ class stateTurnoutControlPowerOff : public xmcApp
 };
 
 /***********************************************************************************************************************
- * Show first main menu  and handle the request.
+ * Route control, select a route and set all turnouts of it.
  */
-class stateMainMenu1 : public xmcApp
+class stateRouteControl : public xmcApp
 {
     /**
-     * Show menu on screen.
+     * Show route screen.
      */
-    void entry() override { m_xmcTft.ShowMenu1(); };
+    void entry() override
+    {
+        m_RouteRunning = false;
+        m_RouteActive  = 0;
+
+        m_xmcTft.ShowTurnoutScreen();
+        routeShow();
+    };
+
+    /**
+     * Sent off commands of turnouts for which the pulse time expired and the commands of a running route.
+     */
+    void react(updateEvent100msec const&) override
+    {
+        turnoutOffUpdate(false);
+        routeUpdate();
+        commandLineUpdate();
+    };
+
+    /**
+     * Handle the response.
+     */
+    void react(XpNetEvent const& e) override
+    {
+        switch (e.dataType)
+        {
+        case none:
+        case powerOn: break;
+        case powerOff: transit<stateTurnoutControlPowerOff>(); break;
+        case powerStop:
+        case locdata: break;
+        case programmingMode:
+            m_PowerStatus = powerStatus::progMode;
+            transit<stateProgrammingMode>();
+            break;
+        case cvResponse:
+        case locDataBase:
+        case locDatabaseTransmit:
+        case turnoutInfo: break;
+        }
+    }
 
     /**
      * Handle pulse switch events.
@@ -1154,45 +1477,137 @@ class stateMainMenu1 : public xmcApp
     {
         switch (e.Status)
         {
-        case turn: transit<stateMainMenu2>(); break;
-        case pushturn: break;
+        case pushturn:
+        case turn:
+            /* Select route when no route is running. */
+            if (m_RouteRunning == false)
+            {
+                if (CheckPulseSwitchRevert(e.Delta) > 0)
+                {
+                    m_RouteIndex = (m_RouteIndex + 1) % RouteTable::ROUTES_MAX;
+                }
+                else if (CheckPulseSwitchRevert(e.Delta) < 0)
+                {
+                    m_RouteIndex = (m_RouteIndex + RouteTable::ROUTES_MAX - 1) % RouteTable::ROUTES_MAX;
+                }
+                routeShow();
+            }
+            break;
         case pushedShort:
+        case released: break;
         case pushedNormal:
         case pushedlong:
-        case released:
-            m_LocSelection = true;
-            transit<stateGetPowerStatus>();
+            /* Back to turnout control. */
+            transit<stateTurnoutControl>();
             break;
+        default: break;
         }
-    }
+    };
 
     /**
-     * Handle switch events.
+     * Handle button events.
      */
     void react(pushButtonsEvent const& e) override
     {
-        /* Handle menu request. */
         switch (e.Button)
         {
-        case button_1:
-            m_locAddressAdd = m_LocLib.GetActualLocAddress();
-            transit<stateMenuLocAdd>();
-            break;
-        case button_2: transit<stateMenuLocFunctionsChange>(); break;
-        case button_3: transit<stateMenuLocDelete>(); break;
+        case button_power: powerSet(csTrackVoltageOff); break;
         case button_4:
-            m_CvPomProgramming = false;
-            transit<stateCvProgramming>();
+            /* Set the turnouts of the selected route. */
+            if ((m_RouteRunning == false) && (m_Route.Steps > 0))
+            {
+                m_RouteStep      = 0;
+                m_RouteRunning   = true;
+                m_RouteStartTime = millis();
+                m_xmcTft.UpdateStatus(m_Route.Name, true, WmcTft::color_yellow);
+            }
             break;
         case button_5:
-            m_CvPomProgramming = true;
-            transit<stateCvProgramming>();
+            /* Learn the selected route, each turnout set in turnout control is added. */
+            if (m_RouteRunning == false)
+            {
+                memset(&m_Route, 0, sizeof(RouteTable::route));
+                snprintf(m_Route.Name, sizeof(m_Route.Name), "ROUTE %u", m_RouteIndex + 1);
+                m_RouteLearn = true;
+                transit<stateTurnoutControl>();
+            }
             break;
-        case button_power:
+        default: break;
+        }
+    };
+
+    /**
+     * When exit and a turnout of the route is active transmit off command.
+     */
+    void exit() override
+    {
+        turnoutOffUpdate(true);
+        m_RouteActive  = 0;
+        m_RouteRunning = false;
+    }
+};
+
+/***********************************************************************************************************************
+ * Show first main menu  and handle the request.
+ */
+class stateMainMenu1 : public xmcApp
+{
+    /**
+     * Show menu on screen.
+     */
+    void entry() override { m_xmcTft.ShowMenu1(); };
+
+    /**
+     * Handle pulse switch events.
+     */
+    void react(pulseSwitchEvent const& e) override
+    {
+        switch (e.Status)
+        {
+        case turn: transit<stateMainMenu2>(); break;
+        case pushturn: break;
+        case pushedShort:
+        case pushedNormal:
+        case pushedlong:
+        case released:
             m_LocSelection = true;
             transit<stateGetPowerStatus>();
             break;
+        }
+    }
+
+    /**
+     * Handle switch events.
+     */
+    void react(pushButtonsEvent const& e) override
+    {
+        /* Handle menu request. */
+        switch (e.Button)
+        {
+        case button_1:
+            m_locAddressAdd = m_LocLib.GetActualLocAddress();
+            transit<stateMenuLocAdd>();
+            break;
+        case button_2: transit<stateMenuLocFunctionsChange>(); break;
+        case button_3: transit<stateMenuLocDelete>(); break;
+        case button_4:
+            m_CvPomProgramming = false;
+            transit<stateCvProgramming>();
+            break;
+        case button_5:
+            m_CvPomProgramming = true;
+            transit<stateCvProgramming>();
+            break;
         case button_0:
+            /* Read the common CVs of the decoder on the programming track. */
+            cvBatchPrepareRead();
+            m_CvBatchMode = cvBatchModeRead;
+            transit<stateCvBatch>();
+            break;
+        case button_power:
+            m_LocSelection = true;
+            transit<stateGetPowerStatus>();
+            break;
         case button_none: break;
         }
     };
@@ -1206,7 +1621,7 @@ class stateMainMenu2 : public xmcApp
     /**
      * Show menu on screen.
      */
-    void entry() override { m_xmcTft.ShowMenu2(m_LocStorage.EmergencyOptionGet(), true); };
+    void entry() override { m_xmcTft.ShowMenu2(m_Settings.EmergencyOptionGet(), true); };
 
     /**
      * Handle pulse switch events.
@@ -1235,26 +1650,40 @@ class stateMainMenu2 : public xmcApp
         /* Handle menu request. */
         switch (e.Button)
         {
-        case button_0: break;
+        case button_0:
+            /* Restore the CV backup of the selected loc, the CVs are read first to write only changed CVs. */
+            if (m_CvBackup.Load(m_LocLib.GetActualLocAddress(), m_CvRestore) == true)
+            {
+                cvBatchPrepareRestore();
+                m_CvBatchMode = cvBatchModeRestoreRead;
+                transit<stateCvBatch>();
+            }
+            else
+            {
+                m_xmcTft.UpdateStatus("NO BACKUP", true, WmcTft::color_red);
+            }
+            break;
         case button_1:
             // Set invalid XpNet device address and go to Xp address menu.
-            m_LocStorage.XpNetAddressSet(255);
+            m_Settings.XpNetAddressSet(255);
+            m_Settings.Commit();
             transit<stateCheckXpNetAddress>();
             break;
         case button_2:
             /* Toggle emergency stop or power off for power button. */
-            if (m_LocStorage.EmergencyOptionGet() == false)
+            if (m_Settings.EmergencyOptionGet() == false)
             {
-                m_LocStorage.EmergencyOptionSet(1);
+                m_Settings.EmergencyOptionSet(true);
                 m_EmergencyStopEnabled = true;
                 m_xmcTft.ShowMenu2(true, false);
             }
             else
             {
-                m_LocStorage.EmergencyOptionSet(0);
+                m_Settings.EmergencyOptionSet(false);
                 m_EmergencyStopEnabled = false;
                 m_xmcTft.ShowMenu2(false, false);
             }
+            m_Settings.Commit();
             break;
         case button_3:
             /* Transmit loc data to control unit. This option is NOT compatible
@@ -1265,19 +1694,20 @@ class stateMainMenu2 : public xmcApp
         case button_4:
             /* Erase loc info and perform reset. */
             m_xmcTft.ShowErase();
-            m_LocLib.InitialLocStore();
-            m_LocStorage.NumberOfLocsSet(1);
+            LocLibErase();
+            m_EepI2c.Flush();
             m_xmcTft.Clear();
             nvic_sys_reset();
             break;
         case button_5:
             /* Erase loc info and set invalid XpNet address. */
             m_xmcTft.ShowErase();
-            m_LocLib.InitialLocStore();
-            m_LocStorage.AcOptionSet(0);
-            m_LocStorage.NumberOfLocsSet(1);
-            m_LocStorage.XpNetAddressSet(255);
-            m_LocStorage.EmergencyOptionSet(0);
+            LocLibErase();
+            m_Settings.AcOptionSet(0);
+            m_Settings.XpNetAddressSet(255);
+            m_Settings.EmergencyOptionSet(false);
+            m_Settings.Commit();
+            m_EmergencyStopEnabled = false;
             transit<stateCheckXpNetAddress>();
             break;
         case button_power:
@@ -1334,7 +1764,7 @@ class stateMenuLocAdd : public xmcApp
         case pushedlong:
             /* If loc is not present goto add functions else red address indicating loc already
              * present. */
-            if (m_LocLib.CheckLoc(m_locAddressAdd) != 255)
+            if (m_LocLib.CheckLoc(m_locAddressAdd) != LOC_NOT_FOUND)
             {
                 m_xmcTft.ShowlocAddress(m_locAddressAdd, WmcTft::color_red);
             }
@@ -1364,7 +1794,7 @@ class stateMenuLocAdd : public xmcApp
         case button_5:
             /* If loc is not present goto add functions else red address indicating loc already
              * present. */
-            if (m_LocLib.CheckLoc(m_locAddressAdd) != 255)
+            if (m_LocLib.CheckLoc(m_locAddressAdd) != LOC_NOT_FOUND)
             {
                 updateScreen = false;
                 m_xmcTft.ShowlocAddress(m_locAddressAdd, WmcTft::color_red);
@@ -1446,6 +1876,7 @@ class stateMenuLocFunctionsAdd : public xmcApp
         case pushedNormal:
             /* Store loc functions */
             m_xmcTft.UpdateStatus("SORTING  ", false, WmcTft::color_white);
+            m_EepI2c.Flush();
             m_LocLib.StoreLoc(m_locAddressAdd, m_locFunctionAssignment, NULL, LocLib::storeAdd);
             m_LocLib.LocBubbleSort();
             m_locAddressAdd++;
@@ -1484,6 +1915,7 @@ class stateMenuLocFunctionsAdd : public xmcApp
         case button_5:
             /* Store loc functions */
             m_xmcTft.UpdateStatus("SORTING  ", false, WmcTft::color_white);
+            m_EepI2c.Flush();
             m_LocLib.StoreLoc(m_locAddressAdd, m_locFunctionAssignment, NULL, LocLib::storeAdd);
             m_LocLib.LocBubbleSort();
             m_locAddressAdd++;
@@ -1558,6 +1990,7 @@ class stateMenuLocFunctionsChange : public xmcApp
             break;
         case pushturn:
             /* Select another loc and update function data of newly selected loc. */
+            m_EepI2c.Flush();
             m_locAddressChange = m_LocLib.GetNextLoc(CheckPulseSwitchRevert(e.Delta));
             m_xmcTft.UpdateSelectedAndNumberOfLocs(m_LocLib.GetActualSelectedLocIndex(), m_LocLib.GetNumberOfLocs());
 
@@ -1572,11 +2005,13 @@ class stateMenuLocFunctionsChange : public xmcApp
         case pushedNormal:
         case pushedlong:
             /* Store changed data and yellow text indicating data is stored. */
+            m_EepI2c.Flush();
             m_LocLib.StoreLoc(m_locAddressChange, m_locFunctionAssignment, NULL, LocLib::storeChange);
             m_xmcTft.ShowlocAddress(m_locAddressChange, WmcTft::color_yellow);
 
             /* Update data. Misuse locselection variable to force update when loc screen is redrawn. */
             m_LocSelection = true;
+            m_EepI2c.Flush();
             m_LocLib.UpdateLocData(m_locAddressChange);
             break;
         default: break;
@@ -1614,12 +2049,14 @@ class stateMenuLocFunctionsChange : public xmcApp
             if (m_LocAddressChangeActive != m_locAddressChange)
             {
                 m_LocSelection = true;
+                m_EepI2c.Flush();
                 m_LocLib.UpdateLocData(m_LocAddressChangeActive);
             }
             transit<stateMainMenu1>();
             break;
         case button_5:
             /* Store changed data and yellow text indicating data is stored. */
+            m_EepI2c.Flush();
             m_LocLib.StoreLoc(m_locAddressChange, m_locFunctionAssignment, NULL, LocLib::storeChange);
             m_xmcTft.ShowlocAddress(m_locAddressChange, WmcTft::color_yellow);
             break;
@@ -1657,6 +2094,7 @@ class stateMenuLocDelete : public xmcApp
         {
         case turn:
             /* Select loc to be deleted. */
+            m_EepI2c.Flush();
             m_locAddressDelete = m_LocLib.GetNextLoc(CheckPulseSwitchRevert(e.Delta));
             m_xmcTft.UpdateSelectedAndNumberOfLocs(m_LocLib.GetActualSelectedLocIndex(), m_LocLib.GetNumberOfLocs());
             m_xmcTft.ShowlocAddress(m_locAddressDelete, WmcTft::color_green);
@@ -1670,7 +2108,9 @@ class stateMenuLocDelete : public xmcApp
             if (m_LocLib.GetNumberOfLocs() > 1)
             {
                 m_xmcTft.UpdateStatus("DELETING", true, WmcTft::color_red);
+                m_EepI2c.Flush();
                 m_LocLib.RemoveLoc(m_locAddressDelete);
+                m_LocStateCache.Invalidate(m_locAddressDelete);
                 m_xmcTft.UpdateStatus("DELETE", true, WmcTft::color_green);
                 m_xmcTft.UpdateSelectedAndNumberOfLocs(
                     m_LocLib.GetActualSelectedLocIndex(), m_LocLib.GetNumberOfLocs());
@@ -1719,8 +2159,10 @@ class stateMenuTransmitLocDatabase : public xmcApp
 {
     void entry() override
     {
-        m_locDbDataTransmitCnt   = 0;
-        m_locDbDataTransmitDelay = millis();
+        m_locDbDataTransmitCnt      = 0;
+        m_locDbDataTransmitDelay    = millis();
+        m_locDbDataTransmitInterval = LOC_DATABASE_TX_DELAY;
+        m_locDbDataTransmitRepeated = false;
 
         m_xmcTft.UpdateStatus("SEND LOC DATA", true, WmcTft::color_white);
         m_XpNet.TransmitLocDatabaseEnable();
@@ -1732,6 +2174,8 @@ class stateMenuTransmitLocDatabase : public xmcApp
     void react(XpNetEvent const& e) override
     {
         LocLibData* LocDbData;
+        cvResponseData* ResponsePtr = NULL;
+        uint16_t NumberOfLocs       = m_LocLib.GetNumberOfLocs();
 
         switch (e.dataType)
         {
@@ -1743,25 +2187,56 @@ class stateMenuTransmitLocDatabase : public xmcApp
             break;
         case powerStop:
         case locdata:
-        case programmingMode:
+        case programmingMode: break;
         case cvResponse:
-        case locDataBase: break;
+            /* Transfer error or busy central, back off and repeat the last transmitted loc. A burst of errors repeats
+             * the loc only once, otherwise the receiver gets several locs twice. */
+            ResponsePtr = (cvResponseData*)(e.Data);
+            if ((ResponsePtr->cvInfo == transmitError) || (ResponsePtr->cvInfo == centralBusy))
+            {
+                m_locDbDataTransmitInterval *= 2;
+                if (m_locDbDataTransmitInterval > LOC_DATABASE_TX_DELAY_MAX)
+                {
+                    m_locDbDataTransmitInterval = LOC_DATABASE_TX_DELAY_MAX;
+                }
+
+                if ((m_locDbDataTransmitCnt > 0) && (m_locDbDataTransmitRepeated == false))
+                {
+                    m_locDbDataTransmitCnt--;
+                    m_locDbDataTransmitRepeated = true;
+                }
+            }
+            break;
+        case locDataBase:
+        case turnoutInfo: break;
         case locDatabaseTransmit:
-            /* Transmit with some delay... */
-            if (millis() - m_locDbDataTransmitDelay >= LOC_DATABASE_TX_DELAY)
+            /* Transmit in the offered window when the actual interval expired. */
+            if (millis() - m_locDbDataTransmitDelay >= m_locDbDataTransmitInterval)
             {
                 m_locDbDataTransmitDelay = millis();
 
-                // Send loc data until last loc is transmitted.
-                m_xmcTft.UpdateTransmitCount(
-                    static_cast<uint8_t>(m_locDbDataTransmitCnt), static_cast<uint8_t>(m_LocLib.GetNumberOfLocs()));
+                /* Window offered without error, speed up. */
+                if (m_locDbDataTransmitInterval > LOC_DATABASE_TX_DELAY + LOC_DATABASE_TX_DELAY_STEP)
+                {
+                    m_locDbDataTransmitInterval -= LOC_DATABASE_TX_DELAY_STEP;
+                }
+                else
+                {
+                    m_locDbDataTransmitInterval = LOC_DATABASE_TX_DELAY;
+                }
+
+                // Send loc data until last loc is transmitted. Display and XpNet messages only hold 8 bit counters.
+                UpdateTransmitProgress(
+                    m_locDbDataTransmitCnt, NumberOfLocs, (m_locDbDataTransmitCnt + 1) >= NumberOfLocs);
 
                 LocDbData = m_LocLib.LocGetAllDataByIndex(m_locDbDataTransmitCnt);
-                m_XpNet.TransmitLocData(LocDbData->Addres >> 8, LocDbData->Addres, m_locDbDataTransmitCnt,
-                    static_cast<uint8_t>(m_LocLib.GetNumberOfLocs()));
+                busMeter.Transmit(BusMeter::categoryLocDatabase, BusMeter::SIZE_LOC_DATA);
+                m_XpNet.TransmitLocData(LocDbData->Addres >> 8, LocDbData->Addres,
+                    static_cast<uint8_t>(m_locDbDataTransmitCnt), static_cast<uint8_t>(NumberOfLocs));
                 m_locDbDataTransmitCnt++;
+                m_locDbDataTransmitRepeated = false;
 
-                if (m_locDbDataTransmitCnt > m_LocLib.GetNumberOfLocs())
+                if (m_locDbDataTransmitCnt >= NumberOfLocs)
                 {
                     m_XpNet.TransmitLocDatabaseDisable();
                     transit<stateMainMenu2>();
@@ -1824,6 +2299,7 @@ class stateCommandLineInterfaceActive : public xmcApp
         m_xmcTft.Clear();
         m_xmcTft.UpdateStatus("COMMAND LINE", true, WmcTft::color_green);
         m_xmcTft.CommandLine();
+        cliReport();
     };
 };
 
@@ -1846,9 +2322,20 @@ class stateCvProgramming : public xmcApp
         else
         {
             EventCv.EventData = startPom;
-            m_XpNet.setPower(csNormal);
+            powerSet(csNormal);
+        }
+
+        /* Another decoder may be on the programming track now, service mode values are only kept while in here. */
+        if (m_CvPomProgramming == false)
+        {
+            m_CvCache.Clear();
         }
 
+        m_PomQueue.Clear();
+        m_CvCacheRequest = 0;
+        m_CvCacheServed  = 0;
+        m_CvCacheAnswer  = false;
+        m_CvCacheVerify  = false;
         send_event(EventCv);
     };
 
@@ -1868,6 +2355,7 @@ class stateCvProgramming : public xmcApp
         case locdata:
         case locDataBase:
         case locDatabaseTransmit:
+        case turnoutInfo:
         case programmingMode: break;
         case cvResponse:
             CvResponsePtr = (cvResponseData*)(e.Data);
@@ -1886,6 +2374,11 @@ class stateCvProgramming : public xmcApp
                 EventCv.EventData = responseReady;
                 EventCv.cvNumber  = CvResponsePtr->cvNumber;
                 EventCv.cvValue   = CvResponsePtr->cvValue;
+                if (m_CvCacheRequest != 0)
+                {
+                    m_CvCache.Store(CV_CACHE_SERVICE_MODE, m_CvCacheRequest, CvResponsePtr->cvValue);
+                    m_CvCacheRequest = 0;
+                }
                 break;
             }
             send_event(EventCv);
@@ -1911,6 +2404,14 @@ class stateCvProgramming : public xmcApp
             Event.EventData.Status = e.Status;
             send_event(Event);
             break;
+        case pushedlong:
+            /* Verify, the next read is done on the decoder even when the CV is cached. */
+            if (m_CvPomProgramming == false)
+            {
+                m_CvCacheVerify = true;
+                m_xmcTft.UpdateStatus("CV VERIFY", true, WmcTft::color_yellow);
+            }
+            break;
         default: break;
         }
     };
@@ -1922,6 +2423,27 @@ class stateCvProgramming : public xmcApp
         send_event(EventCv);
     }
 
+    /**
+     * Transmit queued POM writes.
+     */
+    void react(updateEvent100msec const&) override
+    {
+        cvEvent EventCv;
+
+        commandLineUpdate();
+        pomQueueUpdate(POM_SEND_MAX);
+
+        /* Answer a read from the cache as if the central responded. */
+        if (m_CvCacheAnswer == true)
+        {
+            m_CvCacheAnswer   = false;
+            EventCv.EventData = responseReady;
+            EventCv.cvNumber  = m_CvCacheServed;
+            EventCv.cvValue   = m_CvCacheValue;
+            send_event(EventCv);
+        }
+    }
+
     /**
      * Handle button events.
      */
@@ -1954,14 +2476,54 @@ class stateCvProgramming : public xmcApp
     {
         switch (e.Request)
         {
-        case cvRead: m_XpNet.readCVMode(e.CvNumber); break;
-        case cvWrite: m_XpNet.writeCVMode(e.CvNumber, e.CvValue); break;
-        case cvStatusRequest: m_XpNet.getresultCV(); break;
-        case pomWrite: m_XpNet.writeCvPom(e.Address >> 8, e.Address, e.CvNumber - 1, e.CvValue); break;
+        case cvRead:
+            /* A cached CV is shown right away, unless a verify was requested. */
+            if ((m_CvCacheVerify == false)
+                && (m_CvCache.Get(CV_CACHE_SERVICE_MODE, e.CvNumber, &m_CvCacheValue) == true))
+            {
+                m_CvCacheServed  = e.CvNumber;
+                m_CvCacheRequest = 0;
+                m_CvCacheAnswer  = true;
+            }
+            else
+            {
+                m_CvCacheServed  = 0;
+                m_CvCacheRequest = e.CvNumber;
+                m_CvCacheVerify  = false;
+                cvReadRequest(e.CvNumber);
+            }
+            break;
+        case cvWrite:
+            m_CvCache.Invalidate(CV_CACHE_SERVICE_MODE, e.CvNumber);
+            m_CvCacheServed  = 0;
+            m_CvCacheRequest = 0;
+            busMeter.Transmit(BusMeter::categoryCv, BusMeter::SIZE_CV_WRITE);
+            m_XpNet.writeCVMode(e.CvNumber, e.CvValue);
+            break;
+        case cvStatusRequest:
+            if (m_CvCacheServed != 0)
+            {
+                /* Read was answered from the cache, no request pending at the central. */
+                m_CvCacheAnswer = true;
+            }
+            else
+            {
+                cvResultRequest();
+            }
+            break;
+        case pomWrite:
+            /* Queue the write, when the encoder is turned only the last value of a CV is transmitted. */
+            if (m_PomQueue.Add(e.Address, e.CvNumber, e.CvValue) == false)
+            {
+                pomQueueUpdate(1);
+                m_PomQueue.Add(e.Address, e.CvNumber, e.CvValue);
+            }
+            break;
         case cvExit:
+            pomQueueUpdate(UINT8_MAX);
             if (m_CvPomProgrammingFromPowerOn == false)
             {
-                m_XpNet.setPower(csTrackVoltageOff);
+                powerSet(csTrackVoltageOff);
                 transit<stateMainMenu1>();
             }
             else
@@ -1978,16 +2540,139 @@ class stateCvProgramming : public xmcApp
     void exit() override { m_CvPomProgrammingFromPowerOn = false; };
 };
 
+/***********************************************************************************************************************
+ * Read or write a list of CVs in service mode.
+ */
+class stateCvBatch : public xmcApp
+{
+    /**
+     * Show status and start.
+     */
+    void entry() override
+    {
+        m_xmcTft.Clear();
+        if (m_CvBatchMode == cvBatchModeRead)
+        {
+            m_xmcTft.UpdateStatus("CV READ", true, WmcTft::color_yellow);
+        }
+        else
+        {
+            m_xmcTft.UpdateStatus("CV RESTORE", true, WmcTft::color_yellow);
+        }
+        m_CvBatch.Start(false);
+        m_CvBatchTime = millis();
+        UpdateProgress(0, m_CvBatch.NumberGet(), true);
+    };
+
+    /**
+     * Transmit the requests of the CV batch as soon as they are due.
+     */
+    void react(xpNetEventUpdate const& e) override
+    {
+        xmcApp::react(e);
+        cvBatchUpdate();
+    };
+
+    /**
+     * Handle the response.
+     */
+    void react(XpNetEvent const& e) override
+    {
+        switch (e.dataType)
+        {
+        case none:
+        case powerOn:
+        case powerOff:
+        case powerStop:
+        case locdata:
+        case locDataBase:
+        case locDatabaseTransmit:
+        case turnoutInfo:
+        case programmingMode: break;
+        case cvResponse:
+            if (m_CvBatch.Active() == true)
+            {
+                m_CvBatch.Response((cvResponseData*)(e.Data), millis());
+                UpdateProgress(m_CvBatch.DoneGet(), m_CvBatch.NumberGet(), false);
+
+                if (m_CvBatch.Active() == false)
+                {
+                    cvBatchDone();
+                }
+            }
+            break;
+        }
+    }
+
+    /**
+     * Handle pulse switch events.
+     */
+    void react(pulseSwitchEvent const& e) override
+    {
+        switch (e.Status)
+        {
+        case pushedNormal:
+        case pushedlong:
+            powerSet(csTrackVoltageOff);
+            transit<stateMainMenu1>();
+            break;
+        default: break;
+        }
+    };
+
+    /**
+     * Handle button events.
+     */
+    void react(pushButtonsEvent const& e) override
+    {
+        switch (e.Button)
+        {
+        case button_power:
+            powerSet(csTrackVoltageOff);
+            transit<stateMainMenu1>();
+            break;
+        case button_4:
+            /* Store the read CVs as backup of the selected loc. */
+            if ((m_CvBatchMode == cvBatchModeRead) && (m_CvBatch.Active() == false)
+                && (m_CvBatch.FailedGet() < m_CvBatch.NumberGet()))
+            {
+                if (m_CvBackup.Store(m_LocLib.GetActualLocAddress(), m_CvBatch) == true)
+                {
+                    m_xmcTft.UpdateStatus("CV STORED", true, WmcTft::color_green);
+                }
+                else
+                {
+                    m_xmcTft.UpdateStatus("STORE ERROR", true, WmcTft::color_red);
+                }
+            }
+            break;
+        default: break;
+        }
+    };
+};
+
 /***********************************************************************************************************************
  * Default event handlers when not declared in states itself.
  */
 void xmcApp::react(XpNetEvent const&){};
-void xmcApp::react(xpNetEventUpdate const&) { m_XpNet.receive(); };
+void xmcApp::react(xpNetEventUpdate const&)
+{
+    m_XpNet.receive();
+    m_EepI2c.Update();
+};
 void xmcApp::react(cliEnterEvent const&) { transit<stateCommandLineInterfaceActive>(); };
-void xmcApp::react(updateEvent3sec const&){};
+void xmcApp::react(updateEvent3sec const&)
+{
+    snapshotStore();
+    busMeter.Update(millis());
+
+#if APP_CFG_DIAG == 1
+    diagReport();
+#endif
+};
 void xmcApp::react(pushButtonsEvent const&){};
 void xmcApp::react(pulseSwitchEvent const&){};
-void xmcApp::react(updateEvent100msec const&) { m_WmcCommandLine.Update(); };
+void xmcApp::react(updateEvent100msec const&) { commandLineUpdate(); };
 void xmcApp::react(updateEvent500msec const&){};
 void xmcApp::react(cvProgEvent const&){};
 
@@ -2038,6 +2723,7 @@ void xmcApp::convertLocDataToDisplayData(locData* XpDataPtr, WmcTft::locoInfo* T
 void xmcApp::updateLocInfoOnScreen(bool updateAll)
 {
     uint8_t Index = 0;
+    decoderSteps Steps;
 
     if (m_LocLib.GetActualLocAddress() == m_LocDataReceived.Address)
     {
@@ -2057,10 +2743,17 @@ void xmcApp::updateLocInfoOnScreen(bool updateAll)
         /* Convert decoder steps. */
         switch (m_LocDataReceived.Steps)
         {
-        case 0: m_LocLib.DecoderStepsUpdate(decoderStep14); break;
-        case 2: m_LocLib.DecoderStepsUpdate(decoderStep28); break;
-        case 4: m_LocLib.DecoderStepsUpdate(decoderStep128); break;
-        default: m_LocLib.DecoderStepsUpdate(decoderStep28); break;
+        case 0: Steps = decoderStep14; break;
+        case 2: Steps = decoderStep28; break;
+        case 4: Steps = decoderStep128; break;
+        default: Steps = decoderStep28; break;
+        }
+
+        /* The loc library stores changed decoder steps, finish queued writes only then. */
+        if (Steps != m_LocLib.DecoderStepsGet())
+        {
+            m_EepI2c.Flush();
+            m_LocLib.DecoderStepsUpdate(Steps);
         }
 
         /* Get function assignment of loc. */
@@ -2088,68 +2781,969 @@ void xmcApp::updateLocInfoOnScreen(bool updateAll)
 }
 
 /***********************************************************************************************************************
- * Prepare and transmit loco drive command
+ * Update loc info on screen with the cached data of the selected loc. The loc info request after releasing the pulse
+ * switch corrects the shown data if required.
  */
-void xmcApp::preparAndTransmitLocoDriveCommand(uint16_t SpeedSet)
+bool xmcApp::updateLocInfoFromCache(void)
 {
-    uint8_t Steps = 0;
-    uint8_t Speed = 0;
-    // Determine decoder speed step.
-    switch (m_LocLib.DecoderStepsGet())
-    {
-    case decoderStep14:
-        Steps = 0;
-        Speed = static_cast<uint8_t>(SpeedSet);
-        break;
-    case decoderStep28:
-        Steps = 2;
-        Speed = SpeedStep28TableToDcc[static_cast<uint8_t>(SpeedSet)];
-        break;
-    case decoderStep128:
-        Steps = 4;
-        Speed = SpeedSet;
-        break;
-    }
+    bool Result = false;
 
-    if (m_LocLib.DirectionGet() == directionForward)
+    if (m_LocStateCache.Get(m_LocLib.GetActualLocAddress(), &m_LocDataReceived, millis(), LOC_STATE_CACHE_MAX_AGE)
+        == true)
     {
-        Speed |= 0x80;
+        /* Loc can only be driven with power on. */
+        if (m_PowerStatus != powerStatus::on)
+        {
+            m_LocDataReceived.Speed = 0;
+        }
+
+        updateLocInfoOnScreen(true);
+
+        /* Keep selection active so no loc info is requested until the pulse switch is released. */
+        m_LocSelection = true;
+        Result         = true;
     }
 
-    // Send info and get new data.
-    m_XpNet.setLocoDrive(
-        (uint8_t)(m_LocLib.GetActualLocAddress() >> 8), (uint8_t)(m_LocLib.GetActualLocAddress()), Steps, Speed);
-    m_XpNet.getLocoInfo((uint8_t)(m_LocLib.GetActualLocAddress() >> 8), (uint8_t)(m_LocLib.GetActualLocAddress()));
-    m_SkipRequestCnt = 5;
+    return (Result);
 }
 
 /***********************************************************************************************************************
- * Store and sort received loc data.
+ * Determine the locs next to the selected loc in the loc library which are prefetched while selecting.
  */
-void xmcApp::StoreAndSortLocDatabaseData(void)
+void xmcApp::locPrefetchPrepare(void)
 {
-    uint16_t Index;
-    uint8_t locFunctionAssignment[5] = { 0, 1, 2, 3, 4 };
+    uint8_t Depth;
+    uint8_t PrefetchDepth = sizeof(m_LocPrefetchAddress) / sizeof(m_LocPrefetchAddress[0]) / 2;
+    uint16_t NumberOfLocs = m_LocLib.GetNumberOfLocs();
+    uint16_t Index        = m_LocLib.GetActualSelectedLocIndex() - 1;
 
-    m_xmcTft.UpdateStatus("STORING  ", false, WmcTft::color_white);
+    m_LocPrefetchCnt   = 0;
+    m_LocPrefetchIndex = 0;
 
-    for (Index = 0; Index < m_locDbDataCnt; Index++)
+    for (Depth = 1; (Depth <= PrefetchDepth) && (Depth < NumberOfLocs); Depth++)
     {
-        /* If loc not in data base add it... */
-        if (m_LocLib.CheckLoc(m_locDbData[Index]) == 255)
-        {
-            m_LocLib.StoreLoc(
-                m_locDbData[Index], locFunctionAssignment, &m_locDbDataName[Index][0], LocLib::storeAddNoAutoSelect);
-
+        m_LocPrefetchAddress[m_LocPrefetchCnt++]
+            = m_LocLib.LocGetAllDataByIndex((Index + Depth) % NumberOfLocs)->Addres;
+        m_LocPrefetchAddress[m_LocPrefetchCnt++]
+            = m_LocLib.LocGetAllDataByIndex((Index + NumberOfLocs - Depth) % NumberOfLocs)->Addres;
+    }
+}
+
+/***********************************************************************************************************************
+ * Request loc info of one of the locs to be prefetched which has no recent data in the cache.
+ */
+void xmcApp::locPrefetchUpdate(void)
+{
+    locData LocDataCache;
+    uint16_t Address;
+
+    if ((m_LocSelection == true) && (m_PushButtonReleased == false))
+    {
+        while (m_LocPrefetchIndex < m_LocPrefetchCnt)
+        {
+            Address = m_LocPrefetchAddress[m_LocPrefetchIndex++];
+            if (m_LocStateCache.Get(Address, &LocDataCache, millis(), LOC_PREFETCH_MAX_AGE) == false)
+            {
+                locInfoRequest(Address);
+                break;
+            }
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * Selection finished, check if recent data of the selected loc was present and stop prefetching.
+ */
+void xmcApp::locPrefetchResult(void)
+{
+    locData LocDataCache;
+
+    if (m_LocStateCache.Get(m_LocLib.GetActualLocAddress(), &LocDataCache, millis(), LOC_PREFETCH_MAX_AGE) == true)
+    {
+        m_LocPrefetchHit++;
+    }
+    else
+    {
+        m_LocPrefetchMiss++;
+    }
+
+    m_LocPrefetchCnt   = 0;
+    m_LocPrefetchIndex = 0;
+}
+
+/***********************************************************************************************************************
+ * Prepare and transmit loco drive command
+ */
+void xmcApp::preparAndTransmitLocoDriveCommand(uint16_t SpeedSet)
+{
+    uint8_t Steps = 0;
+    uint8_t Speed = 0;
+    // Determine decoder speed step.
+    switch (m_LocLib.DecoderStepsGet())
+    {
+    case decoderStep14:
+        Steps = 0;
+        Speed = static_cast<uint8_t>(SpeedSet);
+        break;
+    case decoderStep28:
+        Steps = 2;
+        Speed = SpeedStep28TableToDcc[static_cast<uint8_t>(SpeedSet)];
+        break;
+    case decoderStep128:
+        Steps = 4;
+        Speed = SpeedSet;
+        break;
+    }
+
+    if (m_LocLib.DirectionGet() == directionForward)
+    {
+        Speed |= 0x80;
+    }
+
+    // Send info and get new data.
+    busMeter.Transmit(BusMeter::categoryDrive, BusMeter::SIZE_LOC_DRIVE);
+    m_XpNet.setLocoDrive(
+        (uint8_t)(m_LocLib.GetActualLocAddress() >> 8), (uint8_t)(m_LocLib.GetActualLocAddress()), Steps, Speed);
+    locInfoRequest(m_LocLib.GetActualLocAddress());
+    m_SkipRequestCnt = 5;
+}
+
+/***********************************************************************************************************************
+ * Synchronize the loc library with received loc data. New locs are added and locs with a changed name are renamed.
+ * Returns the number of added and renamed locs.
+ */
+uint16_t xmcApp::StoreAndSortLocDatabaseData(void)
+{
+    uint16_t Index;
+    uint16_t Address;
+    uint8_t LocIndex;
+    uint16_t Added                   = 0;
+    uint16_t Changed                 = 0;
+    uint8_t locFunctionAssignment[5] = { 0, 1, 2, 3, 4 };
+    uint8_t FunctionAssignment[5];
+    LocLibData* LocDataPtr;
+    char NameStr[LOC_DB_NAME_LENGTH + 1];
+
+    m_xmcTft.UpdateStatus("STORING  ", false, WmcTft::color_white);
+    m_EepI2c.Flush();
+
+    for (Index = 0; Index < m_locDbDataCnt; Index++)
+    {
+        Address = m_locDbData[Index].Address;
+        memcpy(NameStr, m_locDbData[Index].Name, LOC_DB_NAME_LENGTH);
+        NameStr[LOC_DB_NAME_LENGTH] = '\0';
+        LocIndex = m_LocLib.CheckLoc(Address);
+
+        if (LocIndex == LOC_NOT_FOUND)
+        {
+            /* If loc not in data base add it... */
+            m_LocLib.StoreLoc(Address, locFunctionAssignment, NameStr, LocLib::storeAddNoAutoSelect);
+            Added++;
+
             /* Show increasing counter. */
-            m_xmcTft.UpdateSelectedAndNumberOfLocs(m_LocLib.GetActualSelectedLocIndex(), m_LocLib.GetNumberOfLocs());
+            UpdateProgress(m_LocLib.GetActualSelectedLocIndex(), m_LocLib.GetNumberOfLocs(), false);
+        }
+        else if ((NameStr[0] != '\0') && (NameStr[0] != ' '))
+        {
+            /* Loc present, take over a changed name. Senders without names keep the own name. */
+            LocDataPtr = m_LocLib.LocGetAllDataByIndex(LocIndex);
+            if (strncmp(LocDataPtr->Name, NameStr, LOC_DB_NAME_LENGTH) != 0)
+            {
+                /* The loc data is the record buffer of the loc library itself, copy before storing. */
+                memcpy(FunctionAssignment, LocDataPtr->FunctionAssignment, sizeof(FunctionAssignment));
+                m_LocLib.StoreLoc(Address, FunctionAssignment, NameStr, LocLib::storeChange);
+                Changed++;
+            }
+        }
+    }
+
+    UpdateProgress(m_LocLib.GetActualSelectedLocIndex(), m_LocLib.GetNumberOfLocs(), true);
+
+    /* If all added sort... Sorting is not required when all locs were already present. */
+    if (Added > 0)
+    {
+        m_xmcTft.UpdateStatus("SORTING  ", false, WmcTft::color_white);
+        m_LocLib.LocBubbleSort();
+    }
+
+    return (Added + Changed);
+}
+
+/***********************************************************************************************************************
+ * Count the locs which are not present in the received loc data, and remove them when requested. The last loc is
+ * always kept. Only use when the complete library of the sender was received.
+ */
+uint16_t xmcApp::RemoveMissingLocDatabaseData(bool Remove)
+{
+    uint16_t Address;
+    uint8_t LocIndex;
+    uint16_t Number    = m_LocLib.GetNumberOfLocs();
+    uint16_t Remaining = Number;
+    uint16_t Missing   = 0;
+
+    m_EepI2c.Flush();
+
+    LocIndex = Number;
+    while ((LocIndex > 0) && (Remaining > 1))
+    {
+        LocIndex--;
+        Address = m_LocLib.LocGetAllDataByIndex(LocIndex)->Addres;
+        if (locDatabaseFind(Address) == false)
+        {
+            if (Remove == true)
+            {
+                m_LocLib.RemoveLoc(Address);
+            }
+            Missing++;
+            Remaining--;
         }
     }
 
-    /* If all added sort... */
-    m_xmcTft.UpdateStatus("SORTING  ", false, WmcTft::color_white);
-    m_LocLib.LocBubbleSort();
-    m_xmcTft.UpdateStatus("RESET....", false, WmcTft::color_red);
+    return (Missing);
+}
+
+/***********************************************************************************************************************
+ * Check if all entries 0 .. Total - 1 of the sender were received.
+ */
+bool xmcApp::locDatabaseComplete(uint16_t Total)
+{
+    uint16_t Number;
+    bool Result = (Total > 0);
+
+    for (Number = 0; Number < Total; Number++)
+    {
+        if ((m_locDbDataNumbers[Number >> 3] & (1 << (Number & 7))) == 0)
+        {
+            Result = false;
+            break;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Check if a loc address is present in the received loc data.
+ */
+bool xmcApp::locDatabaseFind(uint16_t Address)
+{
+    uint16_t Index;
+    bool Result = false;
+
+    for (Index = 0; Index < m_locDbDataCnt; Index++)
+    {
+        if (m_locDbData[Index].Address == Address)
+        {
+            Result = true;
+            break;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Transmit the off command of a turnout.
+ */
+void xmcApp::turnoutOff(uint16_t Address)
+{
+    if (Address != 0)
+    {
+        busMeter.Transmit(BusMeter::categoryAccessory, BusMeter::SIZE_TURNOUT);
+        m_XpNet.setTrntPos((Address - 1) >> 8, (uint8_t)(Address - 1), 0x00);
+
+        if ((Address == m_TurnOutAddress) && (m_TurnOutDirection == Forward))
+        {
+            m_TurnOutDirection = ForwardOff;
+            m_xmcTft.ShowTurnoutDirection(static_cast<uint8_t>(m_TurnOutDirection));
+        }
+        else if ((Address == m_TurnOutAddress) && (m_TurnOutDirection == Turn))
+        {
+            m_TurnOutDirection = TurnOff;
+            m_xmcTft.ShowTurnoutDirection(static_cast<uint8_t>(m_TurnOutDirection));
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * Show the turnout address and its last known position. When the position is not known it is requested with the next
+ * update, a turnout which was already asked for is not requested again.
+ */
+void xmcApp::turnoutShow(void)
+{
+    switch (turnoutStateCache.Get(m_TurnOutAddress))
+    {
+    case TurnoutStateCache::turned: m_TurnOutDirection = TurnOff; break;
+    case TurnoutStateCache::straight:
+    case TurnoutStateCache::asked: m_TurnOutDirection = ForwardOff; break;
+    case TurnoutStateCache::unknown:
+        m_TurnOutDirection   = ForwardOff;
+        m_TurnoutInfoRequest = true;
+        break;
+    }
+
+    m_xmcTft.ShowTurnoutAddress(m_TurnOutAddress);
+    m_xmcTft.ShowTurnoutDirection(static_cast<uint8_t>(m_TurnOutDirection));
+}
+
+/***********************************************************************************************************************
+ * Transmit the off commands of turnouts for which the pulse time expired, or of all active turnouts.
+ */
+void xmcApp::turnoutOffUpdate(bool All)
+{
+    uint8_t Index;
+    uint8_t Number;
+    uint16_t Address[TurnoutOffTimer::TIMERS_MAX];
+
+    if (All == true)
+    {
+        Number = m_TurnoutOffTimer.Flush(Address);
+    }
+    else
+    {
+        Number = m_TurnoutOffTimer.Tick(Address);
+    }
+
+    for (Index = 0; Index < Number; Index++)
+    {
+        turnoutOff(Address[Index]);
+    }
+}
+
+/***********************************************************************************************************************
+ * Get the pulse time of turnouts in timer ticks. The pulse time setting is in 10 msec units, when not programmed (0 or
+ * 0xFF) the default is used.
+ */
+uint16_t xmcApp::turnoutPulseTicks(void)
+{
+    uint32_t PulseTime       = TURNOUT_PULSE_TIME;
+    uint8_t TurnoutPulseTime = m_Settings.TurnoutPulseTimeGet();
+
+    if ((TurnoutPulseTime != 0) && (TurnoutPulseTime != 0xFF))
+    {
+        PulseTime = TurnoutPulseTime * 10;
+        if (PulseTime < TURNOUT_PULSE_TIME_MIN)
+        {
+            PulseTime = TURNOUT_PULSE_TIME_MIN;
+        }
+    }
+
+    return ((PulseTime + TURNOUT_TICK_TIME - 1) / TURNOUT_TICK_TIME);
+}
+
+/***********************************************************************************************************************
+ * Read the selected route and show it.
+ */
+void xmcApp::routeShow(void)
+{
+    if (m_Routes.Load(m_RouteIndex, &m_Route) == true)
+    {
+        m_xmcTft.UpdateStatus(m_Route.Name, true, WmcTft::color_green);
+    }
+    else
+    {
+        m_xmcTft.UpdateStatus("ROUTE", true, WmcTft::color_white);
+    }
+
+    m_xmcTft.ShowTurnoutAddress(m_RouteIndex + 1);
+}
+
+/***********************************************************************************************************************
+ * Sent the next step of a running route. The off command of a turnout is sent by the turnout off timer when its pulse
+ * time expired, the next turnout is switched in the same tick so only one turnout coil is active.
+ */
+void xmcApp::routeUpdate(void)
+{
+    uint16_t Address;
+    bool Turn;
+
+    if (m_RouteRunning == true)
+    {
+        /* The next turnout is switched when the pulse time of the previous one expired. */
+        if ((m_RouteActive == 0) || (m_TurnoutOffTimer.Pending(m_RouteActive) == false))
+        {
+            m_RouteActive = 0;
+
+            if (m_RouteStep < m_Route.Steps)
+            {
+                Address = RouteTable::StepAddressGet(m_Route.Step[m_RouteStep]);
+                Turn    = RouteTable::StepTurnGet(m_Route.Step[m_RouteStep]);
+
+                busMeter.Transmit(BusMeter::categoryAccessory, BusMeter::SIZE_TURNOUT);
+                m_XpNet.setTrntPos((Address - 1) >> 8, (uint8_t)(Address - 1), (Turn == true) ? 0x08 : 0x09);
+                turnoutStateCache.Store(
+                    Address, (Turn == true) ? TurnoutStateCache::turned : TurnoutStateCache::straight);
+                turnoutOff(m_TurnoutOffTimer.Start(Address, turnoutPulseTicks()));
+                m_RouteActive = Address;
+                m_RouteStep++;
+            }
+            else
+            {
+                m_RouteRunning = false;
+                m_xmcTft.UpdateStatus(m_Route.Name, true, WmcTft::color_green);
+
+#if APP_CFG_DIAG == 1
+                Serial.print("Route ");
+                Serial.print(m_RouteIndex + 1);
+                Serial.print(" steps ");
+                Serial.print(m_Route.Steps);
+                Serial.print(" msec ");
+                Serial.println(millis() - m_RouteStartTime);
+#endif
+            }
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * Fill the CV batch with the common CVs of a decoder. Version (CV7) and manufacturer (CV8) are not part of a backup,
+ * CV7 is read only and writing CV8 resets most decoders to factory defaults.
+ */
+void xmcApp::cvBatchPrepareRead(void)
+{
+    uint8_t Index;
+    const uint8_t CvList[] = { 1, 2, 3, 4, 5, 6, 17, 18, 19, 29 };
+
+    m_CvBatch.Clear();
+    for (Index = 0; Index < sizeof(CvList); Index++)
+    {
+        m_CvBatch.Add(CvList[Index], 0);
+    }
+}
+
+/***********************************************************************************************************************
+ * Fill the CV batch with the CVs of the backup to be restored.
+ */
+void xmcApp::cvBatchPrepareRestore(void)
+{
+    uint8_t Index;
+    uint16_t CvNumber;
+    uint8_t CvValue;
+
+    m_CvBatch.Clear();
+    for (Index = 0; Index < m_CvRestore.NumberGet(); Index++)
+    {
+        m_CvRestore.Get(Index, &CvNumber, &CvValue);
+        m_CvBatch.Add(CvNumber, 0);
+    }
+}
+
+/***********************************************************************************************************************
+ * Request the loc data of a loc and record the request time.
+ */
+void xmcApp::locInfoRequest(uint16_t Address)
+{
+    if (busRtt.Request(BusRtt::requestLocInfo, Address, millis()) == true)
+    {
+        locPollRate.Missed();
+    }
+
+    busMeter.Transmit(BusMeter::categoryPoll, BusMeter::SIZE_LOC_INFO);
+    m_XpNet.getLocoInfo((uint8_t)(Address >> 8), (uint8_t)(Address));
+}
+
+/***********************************************************************************************************************
+ * Set the track power. The central answers with a broadcast to all devices, so no request time is recorded and the
+ * power status poll rate is only adapted on answers to status requests.
+ */
+void xmcApp::powerSet(uint8_t State)
+{
+    busMeter.Transmit(BusMeter::categoryPower, BusMeter::SIZE_POWER);
+    m_XpNet.setPower(State);
+}
+
+/***********************************************************************************************************************
+ * Request the status of the central and record the request time.
+ */
+void xmcApp::powerStatusRequest(void)
+{
+    if (busRtt.Request(BusRtt::requestPower, BusRtt::ADDRESS_NONE, millis()) == true)
+    {
+        powerPollRate.Missed();
+    }
+
+    busMeter.Transmit(BusMeter::categoryPoll, BusMeter::SIZE_STATUS);
+    m_XpNet.commandStationStatusRequest();
+}
+
+/***********************************************************************************************************************
+ * Request a service mode CV read and record the request time.
+ */
+void xmcApp::cvReadRequest(uint16_t CvNumber)
+{
+    busRtt.Request(BusRtt::requestCvRead, BusRtt::ADDRESS_NONE, millis());
+    busMeter.Transmit(BusMeter::categoryCv, BusMeter::SIZE_CV_READ);
+    m_XpNet.readCVMode(CvNumber);
+}
+
+/***********************************************************************************************************************
+ * Request the service mode result and record the request time.
+ */
+void xmcApp::cvResultRequest(void)
+{
+    busRtt.Request(BusRtt::requestCvResult, BusRtt::ADDRESS_NONE, millis());
+    busMeter.Transmit(BusMeter::categoryCv, BusMeter::SIZE_CV_RESULT);
+    m_XpNet.getresultCV();
+}
+
+/***********************************************************************************************************************
+ * Transmit up to Max queued POM writes.
+ */
+void xmcApp::pomQueueUpdate(uint8_t Max)
+{
+    uint16_t Address;
+    uint16_t CvNumber;
+    uint8_t CvValue;
+
+    while ((Max > 0) && (m_PomQueue.Next(&Address, &CvNumber, &CvValue) == true))
+    {
+        busMeter.Transmit(BusMeter::categoryCv, BusMeter::SIZE_POM_WRITE);
+        m_XpNet.writeCvPom(Address >> 8, Address, CvNumber - 1, CvValue);
+        Max--;
+    }
+}
+
+/***********************************************************************************************************************
+ * Transmit the request of the CV batch which is due. A CV batch ending because of a timeout is handled here, other
+ * endings when the response is received.
+ */
+void xmcApp::cvBatchUpdate(void)
+{
+    uint16_t CvNumber = 0;
+    uint8_t CvValue   = 0;
+    bool Active       = m_CvBatch.Active();
+
+    switch (m_CvBatch.Update(millis(), &CvNumber, &CvValue))
+    {
+    case CvBatch::requestNone: break;
+    case CvBatch::requestRead: cvReadRequest(CvNumber); break;
+    case CvBatch::requestWrite:
+        busMeter.Transmit(BusMeter::categoryCv, BusMeter::SIZE_CV_WRITE);
+        m_XpNet.writeCVMode(CvNumber, CvValue);
+        break;
+    case CvBatch::requestStatus: cvResultRequest(); break;
+    }
+
+    if ((Active == true) && (m_CvBatch.Active() == false))
+    {
+        cvBatchDone();
+    }
+}
+
+/***********************************************************************************************************************
+ * Show the result of the CV batch.
+ */
+void xmcApp::cvBatchDone(void)
+{
+#if APP_CFG_DIAG == 1
+    uint8_t Index;
+    uint16_t CvNumber;
+    uint8_t CvValue;
+#endif
+
+    UpdateProgress(m_CvBatch.DoneGet(), m_CvBatch.NumberGet(), true);
+
+#if APP_CFG_DIAG == 1
+    for (Index = 0; Index < m_CvBatch.NumberGet(); Index++)
+    {
+        Serial.print("CV ");
+        Serial.print(m_CvBatch.Get(Index, &CvNumber, &CvValue) == true ? "ok " : "failed ");
+        Serial.print(CvNumber);
+        Serial.print(" value ");
+        Serial.print(CvValue);
+        Serial.print(" msec ");
+        Serial.println(m_CvBatch.LatencyGet(Index));
+    }
+
+    Serial.print("CV batch msec ");
+    Serial.println(millis() - m_CvBatchTime);
+#endif
+
+    if (m_CvBatchMode == cvBatchModeRestoreRead)
+    {
+        cvBatchRestoreWrite();
+    }
+    else if (m_CvBatch.FailedGet() == 0)
+    {
+        m_xmcTft.UpdateStatus("CV DONE", true, WmcTft::color_green);
+    }
+    else
+    {
+        m_xmcTft.UpdateStatus("CV ERROR", true, WmcTft::color_red);
+    }
+}
+
+/***********************************************************************************************************************
+ * Write the CVs of the backup which differ from the read values or could not be read. Each service mode write takes
+ * hundreds of msec, so skipping equal CVs is the main gain of a restore.
+ */
+void xmcApp::cvBatchRestoreWrite(void)
+{
+    uint8_t Index;
+    uint8_t Number = 0;
+    uint16_t CvNumber;
+    uint8_t CvValue;
+    uint16_t RestoreCvNumber;
+    uint8_t RestoreCvValue;
+    uint16_t CvList[CvBatch::CV_MAX];
+    uint8_t CvValueList[CvBatch::CV_MAX];
+
+    for (Index = 0; Index < m_CvRestore.NumberGet(); Index++)
+    {
+        m_CvRestore.Get(Index, &RestoreCvNumber, &RestoreCvValue);
+
+        /* Never write CV7 or CV8, older backups may still contain them. */
+        if ((RestoreCvNumber != CV_VERSION) && (RestoreCvNumber != CV_MANUFACTURER)
+            && ((m_CvBatch.Get(Index, &CvNumber, &CvValue) == false) || (CvValue != RestoreCvValue)))
+        {
+            CvList[Number]      = RestoreCvNumber;
+            CvValueList[Number] = RestoreCvValue;
+            Number++;
+        }
+    }
+
+#if APP_CFG_DIAG == 1
+    Serial.print("CV restore write ");
+    Serial.print(Number);
+    Serial.print(" skip ");
+    Serial.println(m_CvRestore.NumberGet() - Number);
+#endif
+
+    m_CvBatch.Clear();
+    for (Index = 0; Index < Number; Index++)
+    {
+        m_CvBatch.Add(CvList[Index], CvValueList[Index]);
+    }
+
+    m_CvBatchMode = cvBatchModeRestoreWrite;
+    if (Number > 0)
+    {
+        m_xmcTft.UpdateStatus("CV WRITE", true, WmcTft::color_yellow);
+        m_CvBatch.Start(true);
+        m_CvBatchTime = millis();
+        UpdateProgress(0, Number, true);
+    }
+    else
+    {
+        m_xmcTft.UpdateStatus("CV DONE", true, WmcTft::color_green);
+    }
+}
+
+/***********************************************************************************************************************
+ * Erase the loc library and the application state which refers to it.
+ */
+void xmcApp::LocLibErase(void)
+{
+#if APP_CFG_DIAG == 1
+    uint32_t EraseTime = millis();
+#endif
+
+    m_EepI2c.Flush();
+
+    /* Invalidating the snapshot is sufficient, the rest of the page is not used. */
+    memset(&m_Snapshot, 0xFF, sizeof(resumeSnapshot));
+    m_EepI2c.Write(EepCfg::SnapshotAddress, (uint8_t*)(&m_Snapshot), sizeof(resumeSnapshot));
+
+    m_LocLib.InitialLocStore();
+    m_LocStorage.NumberOfLocsSet(1);
+
+#if APP_CFG_DIAG == 1
+    Serial.print("Loc library erase msec ");
+    Serial.println(millis() - EraseTime);
+#endif
+}
+
+/***********************************************************************************************************************
+ * Handle the command line interface. Commands access the EEPROM through the loc library and loc storage, so queued
+ * writes are finished first when input is pending. Commands may change settings, reload the cached settings after.
+ */
+void xmcApp::commandLineUpdate(void)
+{
+    if (Serial.available() > 0)
+    {
+        m_EepI2c.Flush();
+        m_WmcCommandLine.Update();
+
+        m_Settings.Load(m_EepI2c, m_LocStorage);
+        m_PulseSwitchInvert    = m_Settings.PulseSwitchInvertGet();
+        m_EmergencyStopEnabled = m_Settings.EmergencyOptionGet();
+    }
+}
+
+/***********************************************************************************************************************
+ * Report diagnostic counters on the serial port.
+ */
+void xmcApp::diagReport(void)
+{
+    Serial.print("Loc prefetch hit ");
+    Serial.print(m_LocPrefetchHit);
+    Serial.print(" miss ");
+    Serial.println(m_LocPrefetchMiss);
+
+    Serial.print("Loc data received ");
+    Serial.print(locDataFilter.ReceivedGet());
+    Serial.print(" unchanged ");
+    Serial.println(locDataFilter.DroppedGet());
+
+    Serial.print("Eeprom pages written ");
+    Serial.print(m_EepI2c.PagesWrittenGet());
+    Serial.print(" queue full ");
+    Serial.print(m_EepI2c.QueueFullGet());
+    Serial.print(" wait usec ");
+    Serial.println(m_EepI2c.WaitTimeGet());
+
+    Serial.print("Pom writes ");
+    Serial.print(m_PomQueue.AddedGet());
+    Serial.print(" sent ");
+    Serial.print(m_PomQueue.SentGet());
+    Serial.print(" saved ");
+    Serial.println(m_PomQueue.CombinedGet());
+
+    Serial.print("CV cache hit ");
+    Serial.print(m_CvCache.HitGet());
+    Serial.print(" miss ");
+    Serial.println(m_CvCache.MissGet());
+
+    rttReport();
+    pollReport();
+    busReport();
+}
+
+/***********************************************************************************************************************
+ * Report the XpNet bytes transmitted by this device on the serial port, as rolling bytes per second per category and
+ * the share of the bus capacity in per mille. The rates are updated every 3 seconds.
+ */
+void xmcApp::busReport(void)
+{
+    uint8_t Category;
+    const char* Name[BusMeter::categories] = { "drive", "function", "poll", "accessory", "cv", "power", "locdb" };
+
+    Serial.print("Bus tx");
+    for (Category = 0; Category < BusMeter::categories; Category++)
+    {
+        Serial.print(" ");
+        Serial.print(Name[Category]);
+        Serial.print(" ");
+        Serial.print(busMeter.MessagesGet((BusMeter::category)Category));
+        Serial.print("/");
+        Serial.print(busMeter.RateGet((BusMeter::category)Category));
+    }
+    Serial.print(" share ");
+    Serial.println(busMeter.ShareGet());
+}
+
+/***********************************************************************************************************************
+ * Report the round trip time histograms of the XpNet requests on the serial port. Bucket n counts responses received
+ * within 2^(n+1) msec.
+ */
+void xmcApp::rttReport(void)
+{
+    uint8_t Type;
+    uint8_t Bucket;
+    const char* Name[BusRtt::requestTypes] = { "loc info", "power", "cv read", "cv result" };
+
+    for (Type = 0; Type < BusRtt::requestTypes; Type++)
+    {
+        Serial.print("Rtt ");
+        Serial.print(Name[Type]);
+        Serial.print(" n ");
+        Serial.print(busRtt.NumberGet((BusRtt::requestType)Type));
+        Serial.print(" max ");
+        Serial.print(busRtt.MaxGet((BusRtt::requestType)Type));
+        Serial.print(" timeout ");
+        Serial.print(busRtt.TimeoutGet((BusRtt::requestType)Type));
+        Serial.print(" retry ");
+        Serial.print(busRtt.RetryGet((BusRtt::requestType)Type));
+        Serial.print(" hist");
+        for (Bucket = 0; Bucket < BusRtt::BUCKETS; Bucket++)
+        {
+            Serial.print(" ");
+            Serial.print(busRtt.BucketGet((BusRtt::requestType)Type, Bucket));
+        }
+        Serial.println();
+    }
+}
+
+/***********************************************************************************************************************
+ * Report the actual poll intervals (in skipped updates) and back off counts on the serial port.
+ */
+void xmcApp::pollReport(void)
+{
+    Serial.print("Poll skip loc ");
+    Serial.print(locPollRate.SkipGet());
+    Serial.print(" backoff ");
+    Serial.print(locPollRate.BackoffGet());
+    Serial.print(" power ");
+    Serial.print(powerPollRate.SkipGet());
+    Serial.print(" backoff ");
+    Serial.println(powerPollRate.BackoffGet());
+}
+
+/***********************************************************************************************************************
+ * Start XpNet with the actual XpNet address and get the settings used during control.
+ */
+void xmcApp::XpNetStart(void)
+{
+    m_XpNet.start(m_XpNetAddress, PB0);
+    m_PulseSwitchInvert    = m_Settings.PulseSwitchInvertGet();
+    m_EmergencyStopEnabled = m_Settings.EmergencyOptionGet();
+    bootTimeStamp(bootXpNetStarted);
+}
+
+/***********************************************************************************************************************
+ * Store the time a start up phase is reached for the first time. When the loc can be controlled the start up is
+ * complete.
+ */
+void xmcApp::bootTimeStamp(bootPhase Phase)
+{
+    if ((m_BootPhasesDone & (1 << Phase)) == 0)
+    {
+        m_BootTime[Phase] = millis();
+        m_BootPhasesDone |= (1 << Phase);
+
+#if APP_CFG_DIAG == 1
+        if (Phase == bootLocData)
+        {
+            bootReport();
+        }
+#endif
+    }
+}
+
+/***********************************************************************************************************************
+ * Report the application statistics on the serial port when the command line interface is entered, also available
+ * without APP_CFG_DIAG.
+ */
+void xmcApp::cliReport(void)
+{
+    bootReport();
+    rttReport();
+    pollReport();
+    busReport();
+}
+
+/***********************************************************************************************************************
+ * Report the time of each start up phase and check it against the budget.
+ */
+void xmcApp::bootReport(void)
+{
+    uint8_t Index;
+    const char* PhaseName[bootPhaseMax] = { "start", "tft", "xpnet", "loclib", "power", "locdata" };
+
+    Serial.print("Boot msec");
+    for (Index = 0; Index < bootPhaseMax; Index++)
+    {
+        if ((m_BootPhasesDone & (1 << Index)) != 0)
+        {
+            Serial.print(" ");
+            Serial.print(PhaseName[Index]);
+            Serial.print(" ");
+            Serial.print(m_BootTime[Index]);
+        }
+    }
+
+    if ((m_BootPhasesDone & (1 << bootLocData)) == 0)
+    {
+        Serial.println(" incomplete");
+    }
+    else if (m_BootTime[bootLocData] > BOOT_TIME_BUDGET)
+    {
+        Serial.println(" budget exceeded");
+    }
+    else
+    {
+        Serial.println(" budget ok");
+    }
+}
+
+/***********************************************************************************************************************
+ * Store the application state in EEPROM when it changed. Only stored after the state was verified with the central
+ * after start up.
+ */
+void xmcApp::snapshotStore(void)
+{
+    resumeSnapshot Snapshot;
+
+    if ((m_BootPhasesDone & (1 << bootLocData)) != 0)
+    {
+        memset(&Snapshot, 0, sizeof(resumeSnapshot));
+        Snapshot.Version        = EepCfg::SnapshotVersion;
+        Snapshot.PowerStatus    = static_cast<uint8_t>(m_PowerStatus);
+        Snapshot.Screen         = static_cast<uint8_t>(m_Screen);
+        Snapshot.LocAddress     = m_LocLib.GetActualLocAddress();
+        Snapshot.TurnOutAddress = m_TurnOutAddress;
+        Snapshot.Crc = EepI2c::Crc16((uint8_t*)(&Snapshot), offsetof(resumeSnapshot, Crc));
+
+        /* Only write when power status, screen, loc or turnout changed to limit EEPROM wear. Speed, direction and
+         * functions change all the time while driving, they are not part of the snapshot. */
+        if ((Snapshot.Version != m_Snapshot.Version) || (Snapshot.PowerStatus != m_Snapshot.PowerStatus)
+            || (Snapshot.Screen != m_Snapshot.Screen) || (Snapshot.LocAddress != m_Snapshot.LocAddress)
+            || (Snapshot.TurnOutAddress != m_Snapshot.TurnOutAddress))
+        {
+            if (m_EepI2c.WriteAsync(EepCfg::SnapshotAddress, (uint8_t*)(&Snapshot), sizeof(resumeSnapshot)) == true)
+            {
+                memcpy(&m_Snapshot, &Snapshot, sizeof(resumeSnapshot));
+            }
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * Restore the application state from EEPROM if valid and still matching the selected loc.
+ */
+bool xmcApp::snapshotRestore(void)
+{
+    bool Result = false;
+    resumeSnapshot Snapshot;
+
+    if (m_EepI2c.Read(EepCfg::SnapshotAddress, (uint8_t*)(&Snapshot), sizeof(resumeSnapshot)) == true)
+    {
+        if ((Snapshot.Version == EepCfg::SnapshotVersion)
+            && (Snapshot.Crc == EepI2c::Crc16((uint8_t*)(&Snapshot), offsetof(resumeSnapshot, Crc)))
+            && (Snapshot.LocAddress == m_LocLib.GetActualLocAddress())
+            && (Snapshot.PowerStatus <= static_cast<uint8_t>(powerStatus::progMode))
+            && (Snapshot.TurnOutAddress >= ADDRESS_TURNOUT_MIN) && (Snapshot.TurnOutAddress <= ADDRESS_TURNOUT_MAX))
+        {
+            memcpy(&m_Snapshot, &Snapshot, sizeof(resumeSnapshot));
+
+            m_PowerStatus          = static_cast<powerStatus>(Snapshot.PowerStatus);
+            m_TurnOutAddress       = Snapshot.TurnOutAddress;
+            m_ResumeTurnoutControl = (Snapshot.Screen == static_cast<uint8_t>(screenTurnout));
+
+            Result = true;
+        }
+    }
+
+    return (Result);
+}
+
+/***********************************************************************************************************************
+ * Update progress counter on screen during bulk operations. To limit the time spent on drawing the screen is only
+ * updated each PROGRESS_UPDATE_INTERVAL unless forced, the final value must be forced so it is always shown.
+ */
+void xmcApp::UpdateProgress(uint16_t Selected, uint16_t Number, bool Force)
+{
+#if APP_CFG_PROGRESS_PACING == 1
+    if ((Force == true) || ((millis() - m_ProgressUpdateTime) >= PROGRESS_UPDATE_INTERVAL))
+#endif
+    {
+        m_ProgressUpdateTime = millis();
+        m_xmcTft.UpdateSelectedAndNumberOfLocs(Selected, Number);
+    }
+}
+
+/***********************************************************************************************************************
+ * Update the transmitted loc counter on screen with the same pacing as the progress counter.
+ */
+void xmcApp::UpdateTransmitProgress(uint16_t Transmitted, uint16_t Number, bool Force)
+{
+#if APP_CFG_PROGRESS_PACING == 1
+    if ((Force == true) || ((millis() - m_ProgressUpdateTime) >= PROGRESS_UPDATE_INTERVAL))
+#endif
+    {
+        m_ProgressUpdateTime = millis();
+        m_xmcTft.UpdateTransmitCount(static_cast<uint8_t>(Transmitted), static_cast<uint8_t>(Number));
+    }
 }
 
 /***********************************************************************************************************************
@@ -2158,8 +3752,14 @@ void xmcApp::StoreAndSortLocDatabaseData(void)
 void notifyXNetPower(uint8_t State)
 {
     XpNetEvent Event;
+    uint32_t Rtt;
     Event.dataType = none;
 
+    if (busRtt.Response(BusRtt::requestPower, BusRtt::ADDRESS_NONE, millis(), &Rtt) == true)
+    {
+        powerPollRate.Sample(Rtt);
+    }
+
     switch (State)
     {
     case csNormal: Event.dataType = powerOn; break;
@@ -2201,6 +3801,7 @@ void notifyLokAll(uint8_t Adr_High, uint8_t Adr_Low, boolean Busy, uint8_t Steps
     uint8_t F0, uint8_t F1, uint8_t F2, uint8_t F3, boolean Req)
 {
     XpNetEvent Event;
+    uint32_t Rtt;
     Req = Req;
 
     Event.dataType      = locdata;
@@ -2208,6 +3809,13 @@ void notifyLokAll(uint8_t Adr_High, uint8_t Adr_Low, boolean Busy, uint8_t Steps
 
     LocDataPtr->Address = (uint16_t)(Adr_High) << 8;
     LocDataPtr->Address |= Adr_Low;
+
+    /* Only the response for the requested loc is a round trip, not a broadcast of another loc. */
+    if (busRtt.Response(BusRtt::requestLocInfo, LocDataPtr->Address, millis(), &Rtt) == true)
+    {
+        locPollRate.Sample(Rtt);
+    }
+
     LocDataPtr->Steps = Steps;
 
     /* Convert speed into readable format based on decoder steps. */
@@ -2243,8 +3851,46 @@ void notifyLokAll(uint8_t Adr_High, uint8_t Adr_Low, boolean Busy, uint8_t Steps
         LocDataPtr->Functions |= (uint32_t)(F3) << 21;
         LocDataPtr->Occupied = Busy;
 
-        send_event(Event);
+        /* Only wake up the application when the loc data changed. */
+        if (locDataFilter.Check(LocDataPtr, millis()) == true)
+        {
+            send_event(Event);
+        }
+    }
+}
+
+/***********************************************************************************************************************
+ * Callback function for turnout info. Position 1 is reported for output 0 (turned), 2 for output 1 (straight).
+ */
+void notifyTrnt(uint8_t Adr_High, uint8_t Adr_Low, uint8_t Pos)
+{
+    XpNetEvent Event;
+
+    turnoutInfoData* TurnoutDataPtr = (turnoutInfoData*)(Event.Data);
+    Event.dataType                  = turnoutInfo;
+
+    TurnoutDataPtr->Address = ((uint16_t)(Adr_High) << 8) | Adr_Low;
+    TurnoutDataPtr->Address++;
+
+    switch (Pos)
+    {
+    case 1:
+        TurnoutDataPtr->Position = TurnoutStateCache::turned;
+        turnoutStateCache.Store(TurnoutDataPtr->Address, TurnoutStateCache::turned);
+        break;
+    case 2:
+        TurnoutDataPtr->Position = TurnoutStateCache::straight;
+        turnoutStateCache.Store(TurnoutDataPtr->Address, TurnoutStateCache::straight);
+        break;
+    case 0:
+        /* Never operated, remember it was asked so the position is not requested over and over. */
+        TurnoutDataPtr->Position = TurnoutStateCache::unknown;
+        turnoutStateCache.Store(TurnoutDataPtr->Address, TurnoutStateCache::asked);
+        break;
+    default: TurnoutDataPtr->Position = TurnoutStateCache::unknown; break;
     }
+
+    send_event(Event);
 }
 
 /***********************************************************************************************************************
@@ -2273,6 +3919,10 @@ void notifyLokDataBaseDataReceive(
 void notifyCVInfo(uint8_t State)
 {
     XpNetEvent Event;
+    uint32_t Rtt;
+
+    busRtt.Response(BusRtt::requestCvRead, BusRtt::ADDRESS_NONE, millis(), &Rtt);
+    busRtt.Response(BusRtt::requestCvResult, BusRtt::ADDRESS_NONE, millis(), &Rtt);
 
     Event.dataType            = cvResponse;
     cvResponseData* CvDataPtr = (cvResponseData*)(Event.Data);
@@ -2311,6 +3961,10 @@ void notifyCVInfo(uint8_t State)
 void notifyCVResult(uint8_t cvAdr, uint8_t cvData)
 {
     XpNetEvent Event;
+    uint32_t Rtt;
+
+    busRtt.Response(BusRtt::requestCvRead, BusRtt::ADDRESS_NONE, millis(), &Rtt);
+    busRtt.Response(BusRtt::requestCvResult, BusRtt::ADDRESS_NONE, millis(), &Rtt);
 
     Event.dataType            = cvResponse;
     cvResponseData* CvDataPtr = (cvResponseData*)(Event.Data);
@@ -15,7 +15,22 @@
 #include "WmcCli.h"
 #include "WmcTft.h"
 #include "XpressNet.h"
+#include "app_cfg.h"
+#include "bus_meter.h"
+#include "bus_rtt.h"
+#include "cv_backup.h"
+#include "cv_batch.h"
+#include "cv_cache.h"
+#include "eep_i2c.h"
+#include "loc_state_cache.h"
+#include "poll_rate.h"
+#include "pom_queue.h"
+#include "route_table.h"
+#include "settings_block.h"
+#include "tft_meter.h"
 #include "tinyfsm.hpp"
+#include "turnout_off_timer.h"
+#include "turnout_state_cache.h"
 #include "xmc_event.h"
 
 /***********************************************************************************************************************
@@ -39,6 +54,53 @@ public:
         progMode,
     };
 
+    /**
+     * Phases of the start up of the application.
+     */
+    enum bootPhase
+    {
+        bootStart = 0,
+        bootTftReady,
+        bootXpNetStarted,
+        bootLocLibLoaded,
+        bootPowerStatus,
+        bootLocData,
+        bootPhaseMax,
+    };
+
+    /**
+     * Screen shown during control.
+     */
+    enum appScreen
+    {
+        screenLoc = 0,
+        screenTurnout,
+    };
+
+    /**
+     * Application state stored in EEPROM to restore the screen directly after power on.
+     */
+    struct resumeSnapshot
+    {
+        uint16_t LocAddress;
+        uint16_t TurnOutAddress;
+        uint8_t Version;
+        uint8_t PowerStatus;
+        uint8_t Screen;
+        uint8_t Reserved;
+        uint16_t Crc;
+    };
+
+    /**
+     * CV batch operation.
+     */
+    enum cvBatchMode
+    {
+        cvBatchModeRead = 0,
+        cvBatchModeRestoreRead,
+        cvBatchModeRestoreWrite,
+    };
+
     /**
      * Turnout direction.
      */
@@ -66,20 +128,86 @@ public:
     virtual void entry(void){}; /* entry actions in some states */
     virtual void exit(void){};  /* no exit actions at all */
 
+#if APP_CFG_TFT_METER == 1
+    /**
+     * Report the drawing costs of each state transition.
+     */
+    template <typename S> void transit(void)
+    {
+        tinyfsm::Fsm<xmcApp>::transit<S>();
+        m_xmcTft.ReportTransit(__PRETTY_FUNCTION__);
+    }
+#endif
+
     void convertLocDataToDisplayData(locData* XpDataPtr, WmcTft::locoInfo* TftDataPtr);
     void updateLocInfoOnScreen(bool updateAll);
+    bool updateLocInfoFromCache(void);
+    void locPrefetchPrepare(void);
+    void locPrefetchUpdate(void);
+    void locPrefetchResult(void);
+    void diagReport(void);
     void preparAndTransmitLocoDriveCommand(uint16_t SpeedSet);
-    void StoreAndSortLocDatabaseData(void);
+    uint16_t StoreAndSortLocDatabaseData(void);
+    uint16_t RemoveMissingLocDatabaseData(bool Remove);
+    bool locDatabaseFind(uint16_t Address);
+    bool locDatabaseComplete(uint16_t Total);
+    void LocLibErase(void);
+    void commandLineUpdate(void);
+    void XpNetStart(void);
+    void bootTimeStamp(bootPhase Phase);
+    void cliReport(void);
+    void bootReport(void);
+    void rttReport(void);
+    void pollReport(void);
+    void busReport(void);
+    void snapshotStore(void);
+    bool snapshotRestore(void);
+    void UpdateProgress(uint16_t Selected, uint16_t Number, bool Force);
+    void UpdateTransmitProgress(uint16_t Transmitted, uint16_t Number, bool Force);
     int8_t CheckPulseSwitchRevert(int8_t Delta);
+    void turnoutShow(void);
+    void turnoutOff(uint16_t Address);
+    void turnoutOffUpdate(bool All);
+    uint16_t turnoutPulseTicks(void);
+    void routeShow(void);
+    void routeUpdate(void);
+    void cvBatchPrepareRead(void);
+    void cvBatchPrepareRestore(void);
+    void cvBatchRestoreWrite(void);
+    void cvBatchUpdate(void);
+    void cvBatchDone(void);
+    void pomQueueUpdate(uint8_t Max);
+    void locInfoRequest(uint16_t Address);
+    void powerSet(uint8_t State);
+    void powerStatusRequest(void);
+    void cvReadRequest(uint16_t CvNumber);
+    void cvResultRequest(void);
 
 protected:
+#if APP_CFG_TFT_METER == 1
+    static TftMeter m_xmcTft;
+#else
     static WmcTft m_xmcTft;
+#endif
     static LocLib m_LocLib;
     static XpressNetClass m_XpNet;
     static LocStorage m_LocStorage;
+    static LocStateCache m_LocStateCache;
+    static EepI2c m_EepI2c;
+    static SettingsBlock m_Settings;
+    static resumeSnapshot m_Snapshot;
+    static appScreen m_Screen;
+    static bool m_ResumeTurnoutControl;
+    static uint16_t m_LocPrefetchAddress[2];
+    static uint8_t m_LocPrefetchCnt;
+    static uint8_t m_LocPrefetchIndex;
+    static uint32_t m_LocPrefetchHit;
+    static uint32_t m_LocPrefetchMiss;
     static WmcCli m_WmcCommandLine;
     static uint8_t m_XpNetAddress;
     static uint8_t m_ConnectCount;
+    static uint32_t m_BootTime[bootPhaseMax];
+    static uint8_t m_BootPhasesDone;
     static powerStatus m_PowerStatus;
     static bool m_LocSelection;
     static bool m_PushButtonReleased;
@@ -87,11 +215,33 @@ protected:
     static locData m_LocDataRecievedPrevious;
     static uint8_t m_locFunctionAssignment[5];
     static uint8_t m_SkipRequestCnt;
+    static uint8_t m_PowerPollSkipCnt;
     static WmcTft::locoInfo locInfoActual;
     static WmcTft::locoInfo locInfoPrevious;
     static uint16_t m_TurnOutAddress;
     static turnoutDirection m_TurnOutDirection;
-    static uint32_t m_TurnoutOffDelay;
+    static TurnoutOffTimer m_TurnoutOffTimer;
+    static RouteTable m_Routes;
+    static RouteTable::route m_Route;
+    static uint8_t m_RouteIndex;
+    static uint8_t m_RouteStep;
+    static uint16_t m_RouteActive;
+    static bool m_RouteRunning;
+    static bool m_RouteLearn;
+    static bool m_TurnoutInfoRequest;
+    static CvBatch m_CvBatch;
+    static CvBatch m_CvRestore;
+    static CvBackup m_CvBackup;
+    static cvBatchMode m_CvBatchMode;
+    static uint32_t m_CvBatchTime;
+    static PomQueue m_PomQueue;
+    static CvCache m_CvCache;
+    static uint16_t m_CvCacheRequest;
+    static uint16_t m_CvCacheServed;
+    static uint8_t m_CvCacheValue;
+    static bool m_CvCacheAnswer;
+    static bool m_CvCacheVerify;
+    static uint32_t m_RouteStartTime;
     static bool m_CvPomProgramming;
     static bool m_CvPomProgrammingFromPowerOn;
     static bool m_EmergencyStopEnabled;
@@ -103,17 +253,48 @@ protected:
     static uint8_t m_locFunctionChange;
     static bool m_PulseSwitchInvert;
 
-    static uint16_t m_locDbData[200];
-    static char m_locDbDataName[200][11];
+    static const uint16_t LOC_DATABASE_MAX  = 255; /* Number and total of loc database messages are 8 bits. */
+    static const uint8_t LOC_DB_NAME_LENGTH = 10;  /* Name characters without terminating zero. */
+
+    /**
+     * Received loc database entry, the name is not zero terminated.
+     */
+    struct locDbRecord
+    {
+        uint16_t Address;
+        char Name[LOC_DB_NAME_LENGTH];
+    };
+
+    static locDbRecord m_locDbData[LOC_DATABASE_MAX];
     static uint16_t m_locDbDataCnt;
+    static uint8_t m_locDbDataNumbers[(LOC_DATABASE_MAX / 8) + 1];
+    static uint16_t m_locDbDataChanged;
     static uint16_t m_locDbDataTransmitCnt;
     static uint32_t m_locDbDataTransmitDelay;
+    static uint32_t m_locDbDataTransmitInterval;
+    static bool m_locDbDataTransmitRepeated;
+    static uint32_t m_locDbDataImportTime;
+    static uint32_t m_ProgressUpdateTime;
 
-    static const uint16_t ADDRESS_TURNOUT_MIN   = 1;
-    static const uint16_t ADDRESS_TURNOUT_MAX   = 9999;
-    static const uint8_t FUNCTION_MIN           = 0;
-    static const uint8_t FUNCTION_MAX           = 28;
-    static const uint32_t LOC_DATABASE_TX_DELAY = 200;
+    static const uint16_t ADDRESS_TURNOUT_MIN        = 1;
+    static const uint16_t ADDRESS_TURNOUT_MAX        = 9999;
+    static const uint8_t FUNCTION_MIN                = 0;
+    static const uint8_t FUNCTION_MAX                = 28;
+    static const uint32_t LOC_DATABASE_TX_DELAY      = 20;
+    static const uint32_t LOC_DATABASE_TX_DELAY_MAX  = 400;
+    static const uint32_t LOC_DATABASE_TX_DELAY_STEP = 5;
+    static const uint32_t LOC_STATE_CACHE_MAX_AGE    = 30000;
+    static const uint32_t LOC_PREFETCH_MAX_AGE       = 3000;
+    static const uint32_t PROGRESS_UPDATE_INTERVAL   = 100;
+    static const uint32_t BOOT_TIME_BUDGET           = 1000;
+    static const uint8_t LOC_NOT_FOUND               = 255; /* Result of CheckLoc when loc not present. */
+    static const uint32_t TURNOUT_PULSE_TIME         = 500; /* Default time before turnout off command. */
+    static const uint32_t TURNOUT_PULSE_TIME_MIN     = 100;
+    static const uint32_t TURNOUT_TICK_TIME          = 100; /* Timer wheel runs on 100 msec update event. */
+    static const uint8_t POM_SEND_MAX                = 1;   /* POM writes transmitted per 100 msec update event. */
+    static const uint16_t CV_CACHE_SERVICE_MODE      = 0; /* Cache address of the decoder on the programming track. */
+    static const uint16_t CV_VERSION                 = 7;
+    static const uint16_t CV_MANUFACTURER            = 8;
 
     /* Conversion table for normal speed to 28 steps DCC speed. */
     const uint8_t SpeedStep28TableToDcc[29] = { 16, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23, 8, 24, 9, 25, 10, 26, 11,
@@ -67,6 +67,7 @@ enum xpNetDataType
     cvResponse,
     locDataBase,
     locDatabaseTransmit,
+    turnoutInfo,
 };
 
 enum xpCvInfo
@@ -113,6 +114,15 @@ struct locDatabaseData
     char NameStr[10];
 };
 
+/**
+ * Struct with turnout info data, position 0 unknown, 1 straight, 2 turned.
+ */
+struct turnoutInfoData
+{
+    uint16_t Address;
+    uint8_t Position;
+};
+
 /**
  * Pulse switch event.
  */